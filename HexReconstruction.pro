@@ -21,12 +21,46 @@ win32: LIBS += -lopengl32
 SOURCES += \
     glwidget.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    memory_accounting.cpp \
+    performance_panel.cpp \
+    point_file_loader.cpp
 
 HEADERS += \
+    batch_runner.h \
+    bounded_queue.h \
+    bulk_io.h \
+    cancellation.h \
+    compressed_graph.h \
+    concurrent_key_set.h \
+    differential_check.h \
+    ell_graph.h \
+    enumerators.h \
+    extrusion.h \
+    frame_series.h \
     glwidget.h \
+    hex_validation.h \
+    layer_streaming.h \
     mainwindow.h \
-    reconstruction_engine.h
+    memory_accounting.h \
+    mesh_io.h \
+    parallel.h \
+    parameter_sweep.h \
+    perf_counters.h \
+    performance_panel.h \
+    pipelined_reconstruction.h \
+    point_file_loader.h \
+    point_generators.h \
+    point_io.h \
+    preview_reconstruction.h \
+    progress.h \
+    quantized_points.h \
+    radix_dedup.h \
+    reconstruction_engine.h \
+    reference_engine.h \
+    region_reconstruction.h \
+    scaling_benchmark.h \
+    spatial_index.h
 
 FORMS += \
     mainwindow.ui
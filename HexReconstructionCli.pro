@@ -0,0 +1,48 @@
+# Headless command-line front end to the reconstruction engine (no widgets or OpenGL).
+QT       += core gui
+QT       -= widgets
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TARGET = hexrecon
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# qmake CONFIG+=io_uring enables the io_uring bulk I/O backend (Linux 5.1 or newer).
+io_uring: linux: DEFINES += HEXRECON_IO_URING
+
+SOURCES += \
+    hexrecon_cli.cpp \
+    memory_accounting.cpp
+
+HEADERS += \
+    batch_runner.h \
+    bounded_queue.h \
+    bulk_io.h \
+    cancellation.h \
+    compressed_graph.h \
+    concurrent_key_set.h \
+    differential_check.h \
+    ell_graph.h \
+    enumerators.h \
+    memory_accounting.h \
+    mesh_io.h \
+    parallel.h \
+    parameter_sweep.h \
+    perf_counters.h \
+    pipelined_reconstruction.h \
+    point_generators.h \
+    point_io.h \
+    preview_reconstruction.h \
+    progress.h \
+    radix_dedup.h \
+    reconstruction_engine.h \
+    reference_engine.h \
+    region_reconstruction.h \
+    scaling_benchmark.h \
+    spatial_index.h
+
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
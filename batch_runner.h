@@ -0,0 +1,172 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "reconstruction_engine.h"
+#include "bounded_queue.h"
+#include "point_io.h"
+#include "mesh_io.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @struct BatchJob
+     * @brief One point file to reconstruct and the mesh file to write.
+     */
+    struct BatchJob {
+        QString inputPath;
+        QString outputPath;
+    };
+
+    /**
+     * @struct BatchJobResult
+     * @brief Outcome and stage timings of one batch job.
+     */
+    struct BatchJobResult {
+        bool ok = false;
+        QString error;
+        int points = 0;
+        int hexahedra = 0;
+        double readMs = 0.0;
+        double reconstructMs = 0.0;
+        double writeMs = 0.0;
+    };
+
+    /**
+     * @struct BatchOptions
+     * @brief Thread counts and buffering of the batch pipeline.
+     */
+    struct BatchOptions {
+        int readers = 1;     // Threads loading input files.
+        int workers = 1;     // Threads running Steps 1-3.
+        int writers = 1;     // Threads writing meshes.
+        int queueDepth = 2;  // Loaded and reconstructed jobs buffered between stages.
+        IoBackend io = IoBackend::Synchronous; // Used for the binary .hxp/.hxm formats.
+        FaceTolerances tolerances;
+    };
+
+    /**
+     * @brief Reconstructs many point files with reading, reconstruction and writing overlapped.
+     *
+     * Dedicated reader and writer threads load file N+1 and write file N-1 while the workers
+     * reconstruct file N. The bounded queues between the stages limit the number of clouds in
+     * memory to roughly queueDepth per stage plus one per thread. Results are returned in job
+     * order; `onFinished` (if given) is called once per job, serialized, from whichever thread
+     * completes it. An exception while processing a job (e.g. std::bad_alloc, or
+     * MemoryCeilingExceeded) fails that job with its message; the other jobs carry on.
+     */
+    inline std::vector<BatchJobResult> runBatch(const std::vector<BatchJob>& jobs, const BatchOptions& options,
+                                                const std::function<void(int job, const BatchJobResult&)>& onFinished = nullptr) {
+        typedef std::chrono::steady_clock Clock;
+        auto elapsedMs = [](Clock::time_point since) {
+            return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+        };
+
+        struct InFlight {
+            int job;
+            std::vector<MeshPoint> points;
+            std::vector<Hexahedron> hexahedra;
+        };
+
+        std::vector<BatchJobResult> results(jobs.size());
+        std::mutex finishedMutex;
+        auto finish = [&](int job) {
+            std::lock_guard<std::mutex> lock(finishedMutex);
+            if (onFinished) onFinished(job, results[job]);
+        };
+        // Called from a catch block. Recording the failure may throw in turn (it allocates),
+        // so it is best effort; the job is failed regardless.
+        auto fail = [&](int job, const char* stage, const QString& path) {
+            results[job].ok = false;
+            try {
+                QString reason = "unknown exception";
+                try {
+                    throw;
+                } catch (const std::exception& error) {
+                    reason = QString::fromLocal8Bit(error.what());
+                } catch (...) {
+                }
+                results[job].error = QString("Cannot %1 %2: %3").arg(QString(stage), path, reason);
+                finish(job);
+            } catch (...) {
+            }
+        };
+
+        BoundedQueue<InFlight> loaded(options.queueDepth);
+        BoundedQueue<InFlight> reconstructed(options.queueDepth);
+        std::atomic<int> nextJob(0);
+
+        std::vector<std::thread> readers, workers, writers;
+        for (int r = 0; r < std::max(options.readers, 1); ++r) {
+            readers.emplace_back([&]() {
+                for (int job = nextJob++; job < (int)jobs.size(); job = nextJob++) {
+                    try {
+                        InFlight item;
+                        item.job = job;
+                        Clock::time_point start = Clock::now();
+                        if (!loadPointFile(jobs[job].inputPath, item.points, &results[job].error, options.io)) {
+                            results[job].readMs = elapsedMs(start);
+                            finish(job);
+                            continue;
+                        }
+                        results[job].readMs = elapsedMs(start);
+                        results[job].points = (int)item.points.size();
+                        loaded.push(std::move(item));
+                    } catch (...) {
+                        fail(job, "read", jobs[job].inputPath);
+                    }
+                }
+            });
+        }
+        for (int w = 0; w < std::max(options.workers, 1); ++w) {
+            workers.emplace_back([&]() {
+                InFlight item;
+                while (loaded.pop(item)) {
+                    try {
+                        Clock::time_point start = Clock::now();
+                        ReconstructionResult result = reconstruct(item.points, options.tolerances);
+                        results[item.job].reconstructMs = elapsedMs(start);
+                        results[item.job].hexahedra = (int)result.hexahedra.size();
+                        item.hexahedra.swap(result.hexahedra);
+                        reconstructed.push(std::move(item));
+                    } catch (...) {
+                        item.points = std::vector<MeshPoint>();
+                        fail(item.job, "reconstruct", jobs[item.job].inputPath);
+                    }
+                }
+            });
+        }
+        for (int w = 0; w < std::max(options.writers, 1); ++w) {
+            writers.emplace_back([&]() {
+                InFlight item;
+                while (reconstructed.pop(item)) {
+                    int job = item.job;
+                    try {
+                        Clock::time_point start = Clock::now();
+                        results[job].ok = saveHexMeshFile(jobs[job].outputPath, item.points, item.hexahedra, &results[job].error, options.io);
+                        results[job].writeMs = elapsedMs(start);
+                        item = InFlight();
+                        finish(job);
+                    } catch (...) {
+                        item = InFlight();
+                        fail(job, "write", jobs[job].outputPath);
+                    }
+                }
+            });
+        }
+
+        // Each stage is closed once every producer feeding it has finished.
+        for (std::thread& t : readers) t.join();
+        loaded.close();
+        for (std::thread& t : workers) t.join();
+        reconstructed.close();
+        for (std::thread& t : writers) t.join();
+        return results;
+    }
+} // namespace ReconstructionEngine
+
+#endif // BATCH_RUNNER_H
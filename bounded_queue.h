@@ -0,0 +1,114 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+/**
+ * @class BoundedQueue
+ * @brief A blocking FIFO with a fixed capacity, used to hand work between pipeline threads.
+ *
+ * push() blocks while the queue is full and pop() blocks while it is empty. Once close()
+ * has been called, push() fails and pop() drains the remaining items before returning false.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : m_capacity(capacity ? capacity : 1), m_closed(false) {}
+
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this] { return m_closed || m_items.size() < m_capacity; });
+        if (m_closed) return false;
+        m_items.push_back(std::move(item));
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+        if (m_items.empty()) return false;
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_notEmpty.notify_all();
+        m_notFull.notify_all();
+    }
+
+private:
+    size_t m_capacity;
+    bool m_closed;
+    std::deque<T> m_items;
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+};
+
+/**
+ * @class SpscBoundedQueue
+ * @brief A lock-free ring buffer for exactly one producer thread and one consumer thread.
+ *
+ * The capacity is rounded up to a power of two. push() and pop() spin (yielding) while the
+ * ring is full or empty; after close(), pop() drains the remaining items and then returns false.
+ */
+template <typename T>
+class SpscBoundedQueue {
+public:
+    explicit SpscBoundedQueue(size_t capacity) : m_head(0), m_tail(0), m_closed(false) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        m_buffer.resize(size);
+        m_mask = size - 1;
+    }
+
+    bool tryPush(const T& item) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask) return false;
+        m_buffer[tail & m_mask] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& item) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+        item = std::move(m_buffer[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(const T& item) {
+        while (!tryPush(item)) std::this_thread::yield();
+    }
+
+    bool pop(T& item) {
+        while (!tryPop(item)) {
+            if (m_closed.load(std::memory_order_acquire)) return tryPop(item);
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    void close() { m_closed.store(true, std::memory_order_release); }
+
+private:
+    std::vector<T> m_buffer;
+    size_t m_mask;
+    // Producer and consumer indices live on separate cache lines to avoid false sharing.
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+    std::atomic<bool> m_closed;
+};
+
+#endif // BOUNDED_QUEUE_H
@@ -0,0 +1,104 @@
+#ifndef CANCELLATION_H
+#define CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+
+namespace ReconstructionEngine {
+    /**
+     * @brief How a step ended. A stopped step returns the results it had found so far.
+     */
+    enum class StepStatus {
+        Completed,
+        Cancelled,   // The CancellationToken was triggered.
+        TimedOut     // The deadline passed.
+    };
+
+    inline const char* stepStatusName(StepStatus status) {
+        switch (status) {
+        case StepStatus::Completed: return "completed";
+        case StepStatus::Cancelled: return "cancelled";
+        case StepStatus::TimedOut: return "timed out";
+        }
+        return "";
+    }
+
+    /**
+     * @class CancellationToken
+     * @brief A flag another thread sets to ask running steps to stop.
+     */
+    class CancellationToken {
+    public:
+        CancellationToken() : m_cancelled(false) {}
+
+        void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+        void reset() { m_cancelled.store(false, std::memory_order_relaxed); }
+        bool isCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+    private:
+        CancellationToken(const CancellationToken&) = delete;
+        CancellationToken& operator=(const CancellationToken&) = delete;
+
+        std::atomic<bool> m_cancelled;
+    };
+
+    /**
+     * @struct StopCondition
+     * @brief When a step should give up: on a token, at a deadline, or both. The default
+     * never stops. The token must outlive every step it is passed to.
+     */
+    struct StopCondition {
+        typedef std::chrono::steady_clock Clock;
+
+        const CancellationToken* token = nullptr;
+        Clock::time_point deadline = Clock::time_point::max();
+
+        StopCondition() {}
+        explicit StopCondition(const CancellationToken* token, Clock::time_point deadline = Clock::time_point::max())
+            : token(token), deadline(deadline) {}
+
+        // A deadline `seconds` from now.
+        static StopCondition after(double seconds, const CancellationToken* token = nullptr) {
+            return StopCondition(token, Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+        }
+
+        bool canStop() const { return token || deadline != Clock::time_point::max(); }
+    };
+
+    /**
+     * @class StopCheck
+     * @brief Polls a StopCondition from the outer loop of a step.
+     *
+     * A poll is one relaxed atomic load, plus a steady_clock read if there is a deadline.
+     * Steps poll once per outer iteration, each of which does at least microseconds of work,
+     * so the check costs well under a percent and a stop takes effect within one iteration.
+     * Once stopped it stays stopped. Use one per thread.
+     */
+    class StopCheck {
+    public:
+        explicit StopCheck(const StopCondition& stop) : m_stop(stop), m_status(StepStatus::Completed) {}
+
+        bool shouldStop() {
+            if (m_status != StepStatus::Completed || !m_stop.canStop()) return m_status != StepStatus::Completed;
+            if (m_stop.token && m_stop.token->isCancelled()) {
+                m_status = StepStatus::Cancelled;
+            } else if (m_stop.deadline != StopCondition::Clock::time_point::max() && StopCondition::Clock::now() >= m_stop.deadline) {
+                m_status = StepStatus::TimedOut;
+            }
+            return m_status != StepStatus::Completed;
+        }
+
+        StepStatus status() const { return m_status; }
+
+    private:
+        StopCondition m_stop;
+        StepStatus m_status;
+    };
+
+    // Stores `value` in the optional out-parameter of a step.
+    inline void reportStatus(StepStatus* status, StepStatus value) {
+        if (status) *status = value;
+    }
+} // namespace ReconstructionEngine
+
+#endif // CANCELLATION_H
@@ -0,0 +1,195 @@
+#ifndef COMPRESSED_GRAPH_H
+#define COMPRESSED_GRAPH_H
+
+#include <algorithm>
+#include <cstdint>
+#include "reconstruction_engine.h"
+#include "parallel.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @brief Returns the point indices sorted along a 3D Morton (Z-order) curve.
+     *
+     * Positions are quantized to 21 bits per axis over the bounding box. Reordering a cloud
+     * with permutePoints(points, mortonOrder(points)) gives nearby points nearby indices, which
+     * is what makes the delta-coded rows of CompressedGraph small.
+     */
+    inline std::vector<int> mortonOrder(const std::vector<MeshPoint>& points) {
+        std::vector<int> order(points.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = (int)i;
+        if (points.empty()) return order;
+
+        Vector3 minCorner = points[0].pos, maxCorner = points[0].pos;
+        for (const MeshPoint& p : points) {
+            for (int a = 0; a < 3; ++a) {
+                minCorner[a] = std::min(minCorner[a], p.pos[a]);
+                maxCorner[a] = std::max(maxCorner[a], p.pos[a]);
+            }
+        }
+        Vector3 extent = maxCorner - minCorner;
+        float largest = std::max({extent.x(), extent.y(), extent.z(), 1e-30f});
+
+        // Spreads the low 21 bits of v so that there are two zero bits between each.
+        auto spread = [](uint64_t v) {
+            v &= 0x1fffff;
+            v = (v | v << 32) & 0x1f00000000ffffULL;
+            v = (v | v << 16) & 0x1f0000ff0000ffULL;
+            v = (v | v << 8) & 0x100f00f00f00f00fULL;
+            v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+            v = (v | v << 2) & 0x1249249249249249ULL;
+            return v;
+        };
+        std::vector<uint64_t> codes(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            uint64_t code = 0;
+            for (int a = 0; a < 3; ++a) {
+                uint64_t q = (uint64_t)((points[i].pos[a] - minCorner[a]) / largest * 0x1fffff);
+                code |= spread(q) << a;
+            }
+            codes[i] = code;
+        }
+        std::stable_sort(order.begin(), order.end(), [&codes](int a, int b) { return codes[a] < codes[b]; });
+        return order;
+    }
+
+    /**
+     * @brief Returns the points in the given order: result[k] = points[order[k]].
+     */
+    inline std::vector<MeshPoint> permutePoints(const std::vector<MeshPoint>& points, const std::vector<int>& order) {
+        std::vector<MeshPoint> permuted;
+        permuted.reserve(order.size());
+        for (int idx : order) permuted.push_back(points[idx]);
+        return permuted;
+    }
+
+    /**
+     * @class CompressedGraph
+     * @brief A read-only adjacency graph with delta + varint coded neighbor rows.
+     *
+     * Each row is sorted; its first neighbor is stored as the zigzag-coded difference to the
+     * row's own vertex and every further one as the gap to its predecessor, all as LEB128
+     * varints. With Morton-ordered points most gaps fit in one byte, and row offsets cost four
+     * bytes per vertex plus eight per 1024 vertices. Rows must be appended in vertex order.
+     *
+     * Steps 2 and 3 read it directly through the hasVertex/hasEdge/forEachNeighbor overloads
+     * below; a row is decoded on every access, trading a little CPU for memory.
+     */
+    class CompressedGraph {
+    public:
+        CompressedGraph() {}
+
+        explicit CompressedGraph(const AdjacencyGraph& adjGraph, int vertexCount) {
+            std::vector<int> row;
+            for (int v = 0; v < vertexCount; ++v) {
+                row.clear();
+                auto it = adjGraph.find(v);
+                if (it != adjGraph.end()) row.assign(it->second.begin(), it->second.end());
+                appendRow(row);
+            }
+        }
+
+        // Appends the row of vertex vertexCount(); `neighbors` is sorted in place.
+        void appendRow(std::vector<int>& neighbors) {
+            int v = vertexCount();
+            if ((v & (kBlockSize - 1)) == 0) m_blockOffsets.push_back(m_bytes.size());
+            m_rowOffsets.push_back((uint32_t)(m_bytes.size() - m_blockOffsets.back()));
+
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+            int previous = v;
+            for (size_t k = 0; k < neighbors.size(); ++k) {
+                int64_t delta = (int64_t)neighbors[k] - previous;
+                uint64_t value = k == 0 ? ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63) : (uint64_t)(delta - 1);
+                do {
+                    uint8_t byte = value & 0x7f;
+                    value >>= 7;
+                    m_bytes.push_back(value ? byte | 0x80 : byte);
+                } while (value);
+                previous = neighbors[k];
+            }
+        }
+
+        int vertexCount() const { return (int)m_rowOffsets.size(); }
+
+        size_t memoryBytes() const {
+            return m_bytes.capacity() + m_rowOffsets.capacity() * sizeof(uint32_t) + m_blockOffsets.capacity() * sizeof(uint64_t);
+        }
+
+        // Calls fn(neighbor) for the row of `v` in ascending order until fn returns false.
+        template <typename Fn>
+        void decodeRow(int v, Fn fn) const {
+            const uint8_t* cursor = m_bytes.data() + rowBegin(v);
+            const uint8_t* end = m_bytes.data() + rowEnd(v);
+            int64_t previous = v;
+            bool first = true;
+            while (cursor < end) {
+                uint64_t value = 0;
+                int shift = 0;
+                uint8_t byte;
+                do {
+                    byte = *cursor++;
+                    value |= (uint64_t)(byte & 0x7f) << shift;
+                    shift += 7;
+                } while (byte & 0x80);
+                int64_t neighbor = first ? previous + ((int64_t)(value >> 1) ^ -(int64_t)(value & 1)) : previous + (int64_t)value + 1;
+                first = false;
+                previous = neighbor;
+                if (!fn((int)neighbor)) return;
+            }
+        }
+
+    private:
+        static const int kBlockSize = 1024;
+
+        size_t rowBegin(int v) const { return m_blockOffsets[v / kBlockSize] + m_rowOffsets[v]; }
+        size_t rowEnd(int v) const { return v + 1 < vertexCount() ? rowBegin(v + 1) : m_bytes.size(); }
+
+        std::vector<uint8_t> m_bytes;
+        std::vector<uint32_t> m_rowOffsets;   // Relative to the row's block.
+        std::vector<uint64_t> m_blockOffsets; // One per kBlockSize rows.
+    };
+
+    inline bool hasVertex(const CompressedGraph& graph, int v) { return v >= 0 && v < graph.vertexCount(); }
+
+    inline bool hasEdge(const CompressedGraph& graph, int from, int to) {
+        if (!hasVertex(graph, from)) return false;
+        bool found = false;
+        graph.decodeRow(from, [&](int neighbor) {
+            found = neighbor == to;
+            return neighbor < to;
+        });
+        return found;
+    }
+
+    template <typename Fn>
+    inline void forEachNeighbor(const CompressedGraph& graph, int v, Fn fn) {
+        if (!hasVertex(graph, v)) return;
+        graph.decodeRow(v, [&fn](int neighbor) {
+            fn(neighbor);
+            return true;
+        });
+    }
+
+    /**
+     * @brief Step 1 straight into a CompressedGraph, without building an AdjacencyGraph.
+     *
+     * Rows are computed in parallel one block at a time and compressed in order, so only a
+     * block of uncompressed rows exists at once. Reorder the points with mortonOrder first for
+     * the best compression.
+     */
+    inline CompressedGraph buildCompressedAdjacencyGraph(const std::vector<MeshPoint>& points) {
+        CompressedGraph graph;
+        const int kRowsPerBlock = 4096;
+        std::vector<std::vector<int>> rows(kRowsPerBlock);
+        for (int blockBegin = 0; blockBegin < (int)points.size(); blockBegin += kRowsPerBlock) {
+            int blockEnd = std::min((int)points.size(), blockBegin + kRowsPerBlock);
+            parallelFor(blockBegin, blockEnd, [&](int i) {
+                rows[i - blockBegin] = nearestNeighbors(points, i);
+            }, 16);
+            for (int i = blockBegin; i < blockEnd; ++i) graph.appendRow(rows[i - blockBegin]);
+        }
+        return graph;
+    }
+} // namespace ReconstructionEngine
+
+#endif // COMPRESSED_GRAPH_H
@@ -0,0 +1,289 @@
+#ifndef CONCURRENT_KEY_SET_H
+#define CONCURRENT_KEY_SET_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "reconstruction_engine.h"
+#include "parallel.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @class ConcurrentKeySet
+     * @brief A fixed-capacity, linear-probing hash set of N-int keys that many threads can
+     * insert into at once without locks.
+     *
+     * Each slot has a 32-bit state word: 0 while empty, otherwise a 30-bit fingerprint of the
+     * key's hash plus a "written" flag. A thread claims an empty slot with one CAS, copies the
+     * key in and publishes it by setting the flag. Probes skip slots whose fingerprint differs
+     * without looking at the key, and only wait on a slot that is being written with the same
+     * fingerprint. Keys cannot be removed. The capacity is fixed during a parallel phase
+     * (insert() reports Full beyond 3/4 load); rehash() or reset() grow it between phases.
+     */
+    template <int N>
+    class ConcurrentKeySet {
+    public:
+        using Key = std::array<int, N>;
+
+        enum InsertResult {
+            Inserted,
+            AlreadyPresent,
+            Full
+        };
+
+        explicit ConcurrentKeySet(size_t capacity = 1024) { allocate(capacity); }
+
+        size_t capacity() const { return m_mask + 1; }
+        size_t size() const { return m_size.load(std::memory_order_relaxed); }
+
+        InsertResult insert(const Key& key) {
+            uint64_t hash = hashKey(key);
+            uint32_t claimed = (uint32_t)(hash >> 34) << 2 | kClaimed;
+            uint32_t written = claimed | kWritten;
+            size_t index = (size_t)hash & m_mask;
+            for (size_t probes = 0; probes <= m_mask; ++probes, index = (index + 1) & m_mask) {
+                std::atomic<uint32_t>& state = m_states[index];
+                uint32_t current = state.load(std::memory_order_acquire);
+                if (current == 0) {
+                    // Past 3/4 load, probe sequences grow long; report Full so the caller can grow.
+                    if (m_size.load(std::memory_order_relaxed) >= m_maxLoad) return Full;
+                    if (state.compare_exchange_strong(current, claimed, std::memory_order_acq_rel)) {
+                        m_keys[index] = key;
+                        state.store(written, std::memory_order_release);
+                        m_size.fetch_add(1, std::memory_order_relaxed);
+                        return Inserted;
+                    }
+                    // Lost the race; `current` now holds the winner's state.
+                }
+                if ((current | kWritten) != written) continue;
+                while (current == claimed) {
+                    std::this_thread::yield();
+                    current = state.load(std::memory_order_acquire);
+                }
+                if (m_keys[index] == key) return AlreadyPresent;
+            }
+            return Full;
+        }
+
+        bool contains(const Key& key) const {
+            uint64_t hash = hashKey(key);
+            uint32_t written = (uint32_t)(hash >> 34) << 2 | kClaimed | kWritten;
+            size_t index = (size_t)hash & m_mask;
+            for (size_t probes = 0; probes <= m_mask; ++probes, index = (index + 1) & m_mask) {
+                uint32_t current = m_states[index].load(std::memory_order_acquire);
+                if (current == 0) return false;
+                if (current == written && m_keys[index] == key) return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Grows the table to at least `capacity` slots, keeping the keys. Not thread-safe;
+         * call it between parallel phases.
+         */
+        void rehash(size_t capacity) {
+            std::unique_ptr<std::atomic<uint32_t>[]> states(std::move(m_states));
+            std::vector<Key> keys(std::move(m_keys));
+            size_t oldCapacity = m_mask + 1;
+            allocate(std::max(capacity, oldCapacity));
+            for (size_t i = 0; i < oldCapacity; ++i) {
+                if (states[i].load(std::memory_order_relaxed) != 0) insert(keys[i]);
+            }
+        }
+
+        // Removes all keys and resizes to at least `capacity` slots. Not thread-safe.
+        void reset(size_t capacity) { allocate(capacity); }
+
+        static uint64_t hashKey(const Key& key) {
+            uint64_t h = 0x9e3779b97f4a7c15ULL;
+            for (int v : key) {
+                h ^= (uint32_t)v;
+                h *= 0xff51afd7ed558ccdULL;
+                h ^= h >> 32;
+            }
+            return h;
+        }
+
+    private:
+        static const uint32_t kClaimed = 1;
+        static const uint32_t kWritten = 2;
+
+        void allocate(size_t capacity) {
+            size_t size = 16;
+            while (size < capacity) size <<= 1;
+            m_mask = size - 1;
+            m_maxLoad = size / 4 * 3;
+            m_states.reset(new std::atomic<uint32_t>[size]);
+            for (size_t i = 0; i < size; ++i) m_states[i].store(0, std::memory_order_relaxed);
+            m_keys.assign(size, Key());
+            m_size.store(0, std::memory_order_relaxed);
+        }
+
+        std::unique_ptr<std::atomic<uint32_t>[]> m_states;
+        std::vector<Key> m_keys;
+        size_t m_mask;
+        size_t m_maxLoad;
+        std::atomic<size_t> m_size;
+    };
+
+    template <typename Cell>
+    inline Cell sortedCell(const Cell& cell) {
+        Cell sorted = cell;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted;
+    }
+
+    /**
+     * @brief Step 2 in parallel, deduplicating through one shared ConcurrentKeySet.
+     *
+     * Yields the same set of faces as findValidFaces. Which of the equivalent cycles wins, and
+     * so the order and orientation of the faces, depends on thread timing. If the set fills
+     * up, it is grown and the phase is repeated.
+     */
+    template <typename Graph>
+    inline std::vector<QuadFace> findValidFacesConcurrent(const std::vector<MeshPoint>& points, const Graph& adjGraph,
+                                                          const FaceTolerances& tolerances = FaceTolerances()) {
+        ConcurrentKeySet<4> uniqueFaces(points.size() * 4);
+        for (;;) {
+            std::atomic<bool> full(false);
+            std::vector<std::vector<QuadFace>> perWorker(threadCount());
+            parallelForChunks(0, (int)points.size(), [&](int chunkBegin, int chunkEnd, int worker) {
+                for (int p0_idx = chunkBegin; p0_idx < chunkEnd && !full.load(std::memory_order_relaxed); ++p0_idx) {
+                    forEachFaceCandidate(p0_idx, points, adjGraph, tolerances, [&](const QuadFace& face) {
+                        ConcurrentKeySet<4>::InsertResult result = uniqueFaces.insert(sortedCell(face));
+                        if (result == ConcurrentKeySet<4>::Inserted) perWorker[worker].push_back(face);
+                        if (result == ConcurrentKeySet<4>::Full) full.store(true, std::memory_order_relaxed);
+                    });
+                }
+            });
+            if (!full) {
+                std::vector<QuadFace> faces;
+                for (const std::vector<QuadFace>& part : perWorker) faces.insert(faces.end(), part.begin(), part.end());
+                return faces;
+            }
+            uniqueFaces.reset(uniqueFaces.capacity() * 4);
+        }
+    }
+
+    /**
+     * @brief Step 3 in parallel, deduplicating through one shared ConcurrentKeySet.
+     *
+     * Yields the same set of cells as buildHexahedra; their order and corner labelling depend
+     * on thread timing.
+     */
+    template <typename Graph>
+    inline std::vector<Hexahedron> buildHexahedraConcurrent(const std::vector<QuadFace>& validFaces, const Graph& adjGraph) {
+        ConcurrentKeySet<8> uniqueHexes(validFaces.size() * 2);
+        for (;;) {
+            std::atomic<bool> full(false);
+            std::vector<std::vector<Hexahedron>> perWorker(threadCount());
+            // Rows are dealt out round-robin in small batches, since early rows pair with more faces.
+            std::atomic<int> nextRow(0);
+            const int kBatch = 8;
+            parallelForChunks(0, threadCount(), [&](int, int, int worker) {
+                for (int begin = nextRow.fetch_add(kBatch); begin < (int)validFaces.size() && !full; begin = nextRow.fetch_add(kBatch)) {
+                    int end = std::min(begin + kBatch, (int)validFaces.size());
+                    for (int i = begin; i < end; ++i) {
+                        for (size_t j = i + 1; j < validFaces.size(); ++j) {
+                            Hexahedron hex;
+                            if (!pairOppositeFaces(validFaces[i], validFaces[j], adjGraph, hex)) continue;
+                            ConcurrentKeySet<8>::InsertResult result = uniqueHexes.insert(sortedCell(hex));
+                            if (result == ConcurrentKeySet<8>::Inserted) perWorker[worker].push_back(hex);
+                            if (result == ConcurrentKeySet<8>::Full) full.store(true, std::memory_order_relaxed);
+                        }
+                    }
+                }
+            }, 1);
+            if (!full) {
+                std::vector<Hexahedron> hexahedra;
+                for (const std::vector<Hexahedron>& part : perWorker) hexahedra.insert(hexahedra.end(), part.begin(), part.end());
+                return hexahedra;
+            }
+            uniqueHexes.reset(uniqueHexes.capacity() * 4);
+        }
+    }
+
+    /**
+     * @struct KeySetContention
+     * @brief Insert throughput of the lock-free set and of a mutex-guarded QSet at one thread count.
+     */
+    struct KeySetContention {
+        int threads = 0;
+        double lockFreeMops = 0.0; // Million inserts per second.
+        double mutexMops = 0.0;
+    };
+
+    /**
+     * @brief Measures insert throughput under contention, the way Step 3 uses the set.
+     *
+     * `keyCount` distinct 8-int keys are each inserted `copies` times (every hexahedron is
+     * found once per pair of opposite faces, so three times), interleaved so that threads
+     * race on the same keys. The same workload runs against a QSet behind a mutex.
+     */
+    inline std::vector<KeySetContention> benchmarkKeySetContention(int keyCount, const std::vector<int>& threadCounts, int copies = 3) {
+        typedef std::chrono::steady_clock Clock;
+        std::vector<ConcurrentKeySet<8>::Key> workload;
+        workload.reserve((size_t)keyCount * copies);
+        uint64_t seed = 12345;
+        auto random = [&seed]() {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            return (int)(seed >> 40);
+        };
+        std::vector<ConcurrentKeySet<8>::Key> keys(keyCount);
+        for (ConcurrentKeySet<8>::Key& key : keys) {
+            for (int& v : key) v = random();
+            std::sort(key.begin(), key.end());
+        }
+        for (int c = 0; c < copies; ++c) workload.insert(workload.end(), keys.begin(), keys.end());
+        // Consecutive inserts of the same key land on different threads.
+        for (size_t i = workload.size(); i > 1; --i) std::swap(workload[i - 1], workload[(size_t)random() % i]);
+
+        auto runThreads = [&](int threads, const std::function<void(size_t, size_t)>& work) {
+            Clock::time_point start = Clock::now();
+            std::vector<std::thread> pool;
+            size_t slice = (workload.size() + threads - 1) / threads;
+            for (int t = 0; t < threads; ++t) {
+                size_t begin = std::min(workload.size(), t * slice);
+                size_t end = std::min(workload.size(), begin + slice);
+                pool.emplace_back(work, begin, end);
+            }
+            for (std::thread& thread : pool) thread.join();
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            return workload.size() / 1e6 / std::max(seconds, 1e-9);
+        };
+
+        std::vector<KeySetContention> results;
+        for (int threads : threadCounts) {
+            if (threads < 1) continue;
+            KeySetContention result;
+            result.threads = threads;
+
+            ConcurrentKeySet<8> set((size_t)keyCount * 2);
+            result.lockFreeMops = runThreads(threads, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) set.insert(workload[i]);
+            });
+
+            QSet<QVector<int>> guarded;
+            guarded.reserve(keyCount);
+            std::mutex mutex;
+            result.mutexMops = runThreads(threads, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    QVector<int> key(8);
+                    std::copy(workload[i].begin(), workload[i].end(), key.begin());
+                    std::lock_guard<std::mutex> lock(mutex);
+                    guarded.insert(key);
+                }
+            });
+            results.push_back(result);
+        }
+        return results;
+    }
+} // namespace ReconstructionEngine
+
+#endif // CONCURRENT_KEY_SET_H
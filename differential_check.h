@@ -0,0 +1,502 @@
+#ifndef DIFFERENTIAL_CHECK_H
+#define DIFFERENTIAL_CHECK_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <QString>
+#include <QStringList>
+#include "reference_engine.h"
+#include "reconstruction_engine.h"
+#include "parallel.h"
+#include "point_generators.h"
+#include "scaling_benchmark.h"
+#include "compressed_graph.h"
+#include "ell_graph.h"
+#include "radix_dedup.h"
+#include "concurrent_key_set.h"
+#include "pipelined_reconstruction.h"
+#include "enumerators.h"
+#include "spatial_index.h"
+#include "layer_streaming.h"
+#include "extrusion.h"
+#include "frame_series.h"
+#include "parameter_sweep.h"
+#include "region_reconstruction.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @struct CanonicalMesh
+     * @brief Step outputs in a form that does not depend on iteration order: sorted directed
+     * edges, and faces and cells with sorted corners in sorted order.
+     *
+     * Duplicates are kept, so a path that emits a cell twice does not compare equal.
+     */
+    struct CanonicalMesh {
+        std::vector<std::pair<int, int>> edges;
+        std::vector<QuadFace> faces;
+        std::vector<Hexahedron> hexahedra;
+    };
+
+    template <typename Graph>
+    inline std::vector<std::pair<int, int>> canonicalEdges(const Graph& adjGraph, int vertexCount) {
+        std::vector<std::pair<int, int>> edges;
+        for (int v = 0; v < vertexCount; ++v) {
+            forEachNeighbor(adjGraph, v, [&](int neighbor) { edges.push_back({v, neighbor}); });
+        }
+        std::sort(edges.begin(), edges.end());
+        return edges;
+    }
+
+    template <typename Cell>
+    inline std::vector<Cell> canonicalCells(std::vector<Cell> cells) {
+        for (Cell& cell : cells) std::sort(cell.begin(), cell.end());
+        std::sort(cells.begin(), cells.end());
+        return cells;
+    }
+
+    /**
+     * @brief Describes the first difference between two canonical lists, or returns an empty
+     * string if they are equal.
+     */
+    template <typename T, typename Format>
+    inline QString describeDifference(const std::vector<T>& actual, const std::vector<T>& expected, const QString& what, Format format) {
+        if (actual == expected) return QString();
+        size_t first = 0;
+        while (first < actual.size() && first < expected.size() && actual[first] == expected[first]) ++first;
+        QString detail = QString("%1 %2, reference has %3").arg(actual.size()).arg(what).arg(expected.size());
+        if (first < actual.size()) detail += QString("; first unexpected: %1").arg(format(actual[first]));
+        if (first < expected.size()) detail += QString("; first expected: %1").arg(format(expected[first]));
+        return detail;
+    }
+
+    template <typename Cell>
+    inline QString formatCell(const Cell& cell) {
+        QStringList corners;
+        for (int v : cell) corners << QString::number(v);
+        return "{" + corners.join(",") + "}";
+    }
+
+    inline QString formatEdge(const std::pair<int, int>& edge) { return QString("%1->%2").arg(edge.first).arg(edge.second); }
+
+    /**
+     * @struct DifferentialCase
+     * @brief One input of the differential suite.
+     */
+    struct DifferentialCase {
+        QString name;            // Generator and seed, enough to regenerate the input.
+        std::vector<MeshPoint> points;
+        FaceTolerances tolerances;
+        bool lattice = false;    // A planar-faced grid: z-layers sharing one topology, as streaming and extrusion expect.
+    };
+
+    /**
+     * @struct DifferentialPath
+     * @brief An optimized implementation under test. Each stage may be empty if the path does
+     * not replace it; Steps 2 and 3 receive the reference outputs of the earlier steps, so a
+     * mismatch points at the step that caused it.
+     *
+     * Step 3 depends on the order of its face list: kNN edges are directed, and a face pair is
+     * only tested from the earlier face to the later one. A path that fuses Steps 2 and 3 sets
+     * `step3UsesOwnFaces` and is compared with the reference Step 3 on its own Step 2 output.
+     */
+    struct DifferentialPath {
+        QString name;
+        std::function<std::vector<std::pair<int, int>>(const std::vector<MeshPoint>&)> step1;
+        std::function<std::vector<QuadFace>(const std::vector<MeshPoint>&, const AdjacencyGraph&, const FaceTolerances&)> step2;
+        std::function<std::vector<Hexahedron>(const std::vector<MeshPoint>&, const std::vector<QuadFace>&, const AdjacencyGraph&,
+                                              const FaceTolerances&)> step3;
+        bool step3UsesOwnFaces = false;
+    };
+
+    /**
+     * @struct DifferentialFeature
+     * @brief A feature that reassembles Steps 1-3 in its own way (streaming, extrusion, regions,
+     * frame series, sweeps) and is compared as a whole with the oracle on the cases it applies
+     * to. `check` receives the oracle's canonical hexahedra and returns the first difference,
+     * or an empty string.
+     */
+    struct DifferentialFeature {
+        QString name;
+        std::function<bool(const DifferentialCase&)> appliesTo;
+        std::function<QString(const DifferentialCase&, const std::vector<Hexahedron>& expectedHexahedra)> check;
+    };
+
+    struct DifferentialMismatch {
+        QString caseName;
+        QString path;   // Path or feature name.
+        int threads = 1;
+        QString stage;  // "step1", "step2", "step3", or "result" for a feature.
+        QString detail;
+    };
+
+    struct DifferentialReport {
+        int cases = 0;
+        int comparisons = 0;
+        std::vector<DifferentialMismatch> mismatches;
+    };
+
+    /**
+     * @brief The optimized paths of the engine. QuantizedPointCloud is not listed: it is lossy
+     * by design and may legitimately pick other neighbors on near ties.
+     */
+    inline std::vector<DifferentialPath> optimizedPaths() {
+        std::vector<DifferentialPath> paths;
+
+        DifferentialPath core;
+        core.name = "core";
+        core.step1 = [](const std::vector<MeshPoint>& points) { return canonicalEdges(buildAdjacencyGraph(points), (int)points.size()); };
+        core.step2 = [](const std::vector<MeshPoint>& points, const AdjacencyGraph& graph, const FaceTolerances& tolerances) {
+            return findValidFaces(points, graph, tolerances);
+        };
+        core.step3 = [](const std::vector<MeshPoint>&, const std::vector<QuadFace>& faces, const AdjacencyGraph& graph,
+                        const FaceTolerances&) { return buildHexahedra(faces, graph); };
+        paths.push_back(core);
+
+        // The rows validateHexMesh computes when it is given no graph.
+        DifferentialPath gridKnn;
+        gridKnn.name = "grid-knn";
+        gridKnn.step1 = [](const std::vector<MeshPoint>& points) {
+            UniformGridIndex index(points);
+            AdjacencyGraph graph;
+            for (int i = 0; i < (int)points.size(); ++i) {
+                std::vector<int> nearest = nearestNeighbors(points, index, i);
+                graph[i] = std::unordered_set<int>(nearest.begin(), nearest.end());
+            }
+            return canonicalEdges(graph, (int)points.size());
+        };
+        paths.push_back(gridKnn);
+
+        DifferentialPath parallelStep1;
+        parallelStep1.name = "parallel-step1";
+        parallelStep1.step1 = [](const std::vector<MeshPoint>& points) {
+            return canonicalEdges(buildAdjacencyGraphParallel(points), (int)points.size());
+        };
+        paths.push_back(parallelStep1);
+
+        // The compact graphs are rebuilt from the points so that Steps 2 and 3 read them too.
+        DifferentialPath compressed;
+        compressed.name = "compressed-graph";
+        compressed.step1 = [](const std::vector<MeshPoint>& points) {
+            return canonicalEdges(buildCompressedAdjacencyGraph(points), (int)points.size());
+        };
+        compressed.step2 = [](const std::vector<MeshPoint>& points, const AdjacencyGraph&, const FaceTolerances& tolerances) {
+            return findValidFaces(points, buildCompressedAdjacencyGraph(points), tolerances);
+        };
+        paths.push_back(compressed);
+
+        DifferentialPath ell;
+        ell.name = "ell-graph";
+        ell.step1 = [](const std::vector<MeshPoint>& points) {
+            return canonicalEdges(buildEllAdjacencyGraph<6>(points), (int)points.size());
+        };
+        ell.step2 = [](const std::vector<MeshPoint>& points, const AdjacencyGraph& graph, const FaceTolerances& tolerances) {
+            return findValidFaces(points, EllGraph6(graph, (int)points.size()), tolerances);
+        };
+        ell.step3 = [](const std::vector<MeshPoint>& points, const std::vector<QuadFace>& faces, const AdjacencyGraph& graph,
+                       const FaceTolerances&) { return buildHexahedra(faces, EllGraph6(graph, (int)points.size())); };
+        paths.push_back(ell);
+
+        DifferentialPath radix;
+        radix.name = "radix-dedup";
+        radix.step2 = [](const std::vector<MeshPoint>& points, const AdjacencyGraph& graph, const FaceTolerances& tolerances) {
+            return findValidFacesRadix(points, graph, tolerances);
+        };
+        radix.step3 = [](const std::vector<MeshPoint>&, const std::vector<QuadFace>& faces, const AdjacencyGraph& graph,
+                         const FaceTolerances&) { return buildHexahedraRadix(faces, graph); };
+        paths.push_back(radix);
+
+        DifferentialPath concurrent;
+        concurrent.name = "lock-free-dedup";
+        concurrent.step2 = [](const std::vector<MeshPoint>& points, const AdjacencyGraph& graph, const FaceTolerances& tolerances) {
+            return findValidFacesConcurrent(points, graph, tolerances);
+        };
+        concurrent.step3 = [](const std::vector<MeshPoint>&, const std::vector<QuadFace>& faces, const AdjacencyGraph& graph,
+                              const FaceTolerances&) {
+            return buildHexahedraConcurrent(faces, graph);
+        };
+        paths.push_back(concurrent);
+
+        DifferentialPath lazy;
+        lazy.name = "enumerators";
+        lazy.step2 = [](const std::vector<MeshPoint>& points, const AdjacencyGraph& graph, const FaceTolerances& tolerances) {
+            std::vector<QuadFace> faces;
+            for (const QuadFace& face : enumerateFaces(points, graph, tolerances)) faces.push_back(face);
+            return faces;
+        };
+        lazy.step3 = [](const std::vector<MeshPoint>&, const std::vector<QuadFace>& faces, const AdjacencyGraph& graph,
+                        const FaceTolerances&) {
+            std::vector<Hexahedron> hexahedra;
+            for (const Hexahedron& hex : enumerateHexahedra(faces, graph)) hexahedra.push_back(hex);
+            return hexahedra;
+        };
+        paths.push_back(lazy);
+
+        // The pipeline fuses Steps 2 and 3 and pairs the faces in its sweep order.
+        DifferentialPath pipelined;
+        pipelined.name = "pipelined";
+        pipelined.step2 = [](const std::vector<MeshPoint>& points, const AdjacencyGraph& graph, const FaceTolerances& tolerances) {
+            std::vector<QuadFace> faces;
+            reconstructPipelined(points, graph, tolerances, &faces);
+            return faces;
+        };
+        pipelined.step3 = [](const std::vector<MeshPoint>& points, const std::vector<QuadFace>&, const AdjacencyGraph& graph,
+                             const FaceTolerances& tolerances) { return reconstructPipelined(points, graph, tolerances).hexahedra; };
+        pipelined.step3UsesOwnFaces = true;
+        paths.push_back(pipelined);
+
+        return paths;
+    }
+
+    /**
+     * @brief The features checked against the oracle. Streaming and extrusion only apply to
+     * lattices, since they need exact z-layers. Regions are a box and a sphere in the middle of
+     * the bounding box, compared with the oracle's cells whose centroid lies inside. The frame
+     * series advances by an identical frame. The sweep compares its counts with the oracle's
+     * at the case's own tolerances and on a grid around the defaults.
+     */
+    inline std::vector<DifferentialFeature> differentialFeatures() {
+        std::vector<DifferentialFeature> features;
+        auto isLattice = [](const DifferentialCase& c) { return c.lattice; };
+        auto always = [](const DifferentialCase&) { return true; };
+        auto compareHexahedra = [](const std::vector<Hexahedron>& actual, const std::vector<Hexahedron>& expected) {
+            return describeDifference(canonicalCells(actual), expected, "hexahedra", formatCell<Hexahedron>);
+        };
+        // Stream positions back to input indices.
+        auto toInput = [](std::vector<Hexahedron> hexahedra, const std::vector<int>& streamToInput) {
+            for (Hexahedron& hex : hexahedra) {
+                for (int& idx : hex) idx = streamToInput[idx];
+            }
+            return hexahedra;
+        };
+
+        DifferentialFeature stream;
+        stream.name = "layer-stream";
+        stream.appliesTo = isLattice;
+        stream.check = [=](const DifferentialCase& c, const std::vector<Hexahedron>& expected) {
+            std::vector<int> streamToInput;
+            std::vector<std::vector<MeshPoint>> layers = splitIntoLayers(c.points, 1e-3f, &streamToInput);
+            size_t next = 0;
+            std::vector<Hexahedron> hexahedra;
+            reconstructLayerStream([&](std::vector<MeshPoint>& layer) {
+                if (next == layers.size()) return false;
+                layer = layers[next++];
+                return true;
+            }, [&](const std::vector<Hexahedron>& slab) { hexahedra.insert(hexahedra.end(), slab.begin(), slab.end()); });
+            return compareHexahedra(toInput(hexahedra, streamToInput), expected);
+        };
+        features.push_back(stream);
+
+        DifferentialFeature extrusion;
+        extrusion.name = "extrusion";
+        extrusion.appliesTo = isLattice;
+        extrusion.check = [=](const DifferentialCase& c, const std::vector<Hexahedron>& expected) {
+            std::vector<int> streamToInput;
+            std::vector<std::vector<MeshPoint>> layers = splitIntoLayers(c.points, 1e-3f, &streamToInput);
+            return compareHexahedra(toInput(reconstructExtrusion(layers).hexahedra, streamToInput), expected);
+        };
+        features.push_back(extrusion);
+
+        for (int shape = 0; shape < 2; ++shape) {
+            DifferentialFeature region;
+            region.name = shape == 0 ? "region-box" : "region-sphere";
+            region.appliesTo = [](const DifferentialCase& c) { return !c.points.empty(); };
+            region.check = [=](const DifferentialCase& c, const std::vector<Hexahedron>& expected) {
+                Vector3 lo = c.points[0].pos, hi = c.points[0].pos;
+                for (const MeshPoint& p : c.points) {
+                    for (int a = 0; a < 3; ++a) {
+                        lo[a] = std::min(lo[a], p.pos[a]);
+                        hi[a] = std::max(hi[a], p.pos[a]);
+                    }
+                }
+                Vector3 extent = hi - lo;
+                float longest = std::max(extent.x(), std::max(extent.y(), extent.z()));
+                RegionOfInterest roi = shape == 0 ? RegionOfInterest::box(lo + extent * 0.3f, lo + extent * 0.8f)
+                                                  : RegionOfInterest::sphere(lo + extent * 0.5f, 0.35f * longest);
+                std::vector<Hexahedron> inside;
+                for (const Hexahedron& hex : expected) {
+                    if (roi.contains(centroidOf(c.points, hex))) inside.push_back(hex);
+                }
+                return compareHexahedra(reconstructRegion(c.points, roi, c.tolerances).hexahedra, inside);
+            };
+            features.push_back(region);
+        }
+
+        DifferentialFeature series;
+        series.name = "frame-series";
+        series.appliesTo = always;
+        series.check = [=](const DifferentialCase& c, const std::vector<Hexahedron>& expected) {
+            FrameSeriesReconstructor reconstructor(c.tolerances);
+            reconstructor.reset(c.points);
+            reconstructor.advance(c.points);
+            return compareHexahedra(reconstructor.hexahedra(), expected);
+        };
+        features.push_back(series);
+
+        DifferentialFeature sweep;
+        sweep.name = "tolerance-sweep";
+        sweep.appliesTo = always;
+        sweep.check = [](const DifferentialCase& c, const std::vector<Hexahedron>&) {
+            std::vector<FaceTolerances> settings = {c.tolerances};
+            for (float coplanarity : {1e-3f, 0.05f, 0.5f}) {
+                for (float ratio : {1.0f, 1.01f, 1.2f}) settings.push_back(FaceTolerances(coplanarity, ratio));
+            }
+            ToleranceSweep toleranceSweep(c.points);
+            std::vector<SweepResult> results = toleranceSweep.evaluate(settings);
+            AdjacencyGraph graph = ReferenceEngine::buildAdjacencyGraph(c.points);
+            for (const SweepResult& result : results) {
+                std::vector<QuadFace> faces = ReferenceEngine::findValidFaces(c.points, graph, result.tolerances);
+                int hexahedra = (int)ReferenceEngine::buildHexahedra(faces, graph).size();
+                if (result.faces == (int)faces.size() && result.hexahedra == hexahedra) continue;
+                return QString("coplanarity %1, diagonal ratio %2: %3 faces and %4 hexahedra, reference has %5 and %6")
+                    .arg(result.tolerances.coplanarity).arg(result.tolerances.diagonalRatio).arg(result.faces)
+                    .arg(result.hexahedra).arg(faces.size()).arg(hexahedra);
+            }
+            return QString();
+        };
+        features.push_back(sweep);
+
+        return features;
+    }
+
+    /**
+     * @struct DifferentialOptions
+     * @brief Parameters of the generated suite.
+     */
+    struct DifferentialOptions {
+        int randomCases = 40;                  // Per generator: grids, two kinds of perturbed grids, noisy clouds.
+        uint32_t seed = 1;
+        std::vector<int> threadCounts = {1, 4}; // Parallel paths are run at each count.
+    };
+
+    /**
+     * @brief Generates the inputs of the suite: fixed edge cases, then `randomCases` each of
+     * regular grids, grids perturbed per lattice line and per point, and noisy clouds. Sizes stay small, since the reference
+     * Step 3 is quadratic in the number of faces.
+     */
+    inline std::vector<DifferentialCase> generateDifferentialCases(const DifferentialOptions& options) {
+        std::vector<DifferentialCase> cases;
+        auto add = [&cases](const QString& name, const std::vector<MeshPoint>& points, const FaceTolerances& tolerances) {
+            DifferentialCase c;
+            c.name = name;
+            c.points = points;
+            c.tolerances = tolerances;
+            cases.push_back(c);
+        };
+
+        // Edge cases.
+        add("empty", {}, FaceTolerances());
+        add("single point", {{Vector3(0, 0, 0), 3}}, FaceTolerances());
+        add("two points", {{Vector3(0, 0, 0), 1}, {Vector3(1, 0, 0), 1}}, FaceTolerances());
+        add("single cell", generateGridPoints(2, 2, 2), FaceTolerances());
+        cases.back().lattice = true;
+        add("flat layer", generateGridPoints(5, 4, 1), FaceTolerances());
+        add("line", generateGridPoints(6, 1, 1), FaceTolerances());
+        std::vector<MeshPoint> doubled = generateGridPoints(3, 3, 2);
+        std::vector<MeshPoint> copies = doubled;
+        doubled.insert(doubled.end(), copies.begin(), copies.end());
+        add("coincident points", doubled, FaceTolerances());
+        std::vector<MeshPoint> greedy = generateGridPoints(3, 3, 3);
+        for (size_t i = 0; i < greedy.size(); ++i) greedy[i].required_neighbors = (int)(i % 3 == 0 ? 100 : i % 3 == 1 ? 0 : -1);
+        add("degenerate neighbor counts", greedy, FaceTolerances());
+        add("loose tolerances", generateGridPoints(3, 3, 3, 1.0f, 0.3f, 1, GridJitter::PerPoint), FaceTolerances(0.5f, 1.0f));
+
+        uint32_t state = options.seed;
+        auto random = [&state]() {
+            state = state * 1664525u + 1013904223u;
+            return state >> 8;
+        };
+        auto uniform = [&random]() { return random() / float(1 << 24); };
+
+        for (int c = 0; c < options.randomCases; ++c) {
+            uint32_t caseSeed = random();
+            int nx = 1 + random() % 5, ny = 1 + random() % 5, nz = 1 + random() % 4;
+            add(QString("grid %1x%2x%3").arg(nx).arg(ny).arg(nz), generateGridPoints(nx, ny, nz, 0.5f + uniform()), FaceTolerances());
+            cases.back().lattice = true;
+            // Per-line jitter keeps the faces planar, so the face and cell dedup see full meshes;
+            // per-point jitter needs loose tolerances to let its tilted faces through.
+            add(QString("perturbed grid %1x%2x%3 seed %4").arg(nx).arg(ny).arg(nz).arg(caseSeed),
+                generateGridPoints(nx, ny, nz, 1.0f, 0.25f, caseSeed, GridJitter::PerLine), FaceTolerances());
+            cases.back().lattice = true;
+            add(QString("per-point perturbed grid %1x%2x%3 seed %4").arg(nx).arg(ny).arg(nz).arg(caseSeed),
+                generateGridPoints(nx, ny, nz, 1.0f, 0.25f, caseSeed, GridJitter::PerPoint), FaceTolerances(0.5f, 1.0f));
+
+            // Noisy clouds exercise arbitrary graphs; the loose tolerances let faces through.
+            std::vector<MeshPoint> cloud(8 + random() % 40);
+            for (MeshPoint& p : cloud) {
+                p.pos = Vector3(uniform() * 4, uniform() * 4, uniform() < 0.5f ? 0.0f : uniform() * 4);
+                p.required_neighbors = (int)(random() % 7);
+            }
+            add(QString("noisy cloud %1 points seed %2").arg(cloud.size()).arg(caseSeed), cloud, FaceTolerances(0.5f, 1.0f));
+        }
+        return cases;
+    }
+
+    /**
+     * @brief Runs every path on every case at every thread count and compares the canonical
+     * outputs of each step with ReferenceEngine, then does the same for every feature that
+     * applies to the case. The global thread count is restored afterwards.
+     */
+    inline DifferentialReport runDifferentialChecks(const std::vector<DifferentialCase>& cases, const std::vector<DifferentialPath>& paths,
+                                                    const std::vector<int>& threadCounts,
+                                                    const std::vector<DifferentialFeature>& features = std::vector<DifferentialFeature>()) {
+        DifferentialReport report;
+        const int previousThreads = threadCountSetting().load();
+        for (const DifferentialCase& c : cases) {
+            ++report.cases;
+            AdjacencyGraph graph = ReferenceEngine::buildAdjacencyGraph(c.points);
+            std::vector<QuadFace> faces = ReferenceEngine::findValidFaces(c.points, graph, c.tolerances);
+            std::vector<Hexahedron> hexahedra = ReferenceEngine::buildHexahedra(faces, graph);
+            CanonicalMesh expected;
+            expected.edges = canonicalEdges(graph, (int)c.points.size());
+            expected.faces = canonicalCells(faces);
+            expected.hexahedra = canonicalCells(hexahedra);
+
+            for (int threads : threadCounts) {
+                setThreadCount(std::max(threads, 1));
+                for (const DifferentialPath& path : paths) {
+                    auto check = [&](const QString& stage, const QString& detail) {
+                        ++report.comparisons;
+                        if (detail.isEmpty()) return;
+                        DifferentialMismatch mismatch;
+                        mismatch.caseName = c.name;
+                        mismatch.path = path.name;
+                        mismatch.threads = threads;
+                        mismatch.stage = stage;
+                        mismatch.detail = detail;
+                        report.mismatches.push_back(mismatch);
+                    };
+                    if (path.step1) check("step1", describeDifference(path.step1(c.points), expected.edges, "edges", formatEdge));
+                    std::vector<QuadFace> ownFaces;
+                    if (path.step2) {
+                        ownFaces = path.step2(c.points, graph, c.tolerances);
+                        check("step2", describeDifference(canonicalCells(ownFaces), expected.faces, "faces", formatCell<QuadFace>));
+                    }
+                    if (path.step3) {
+                        std::vector<Hexahedron> expectedHexahedra = path.step3UsesOwnFaces
+                            ? canonicalCells(ReferenceEngine::buildHexahedra(ownFaces, graph)) : expected.hexahedra;
+                        check("step3", describeDifference(canonicalCells(path.step3(c.points, faces, graph, c.tolerances)), expectedHexahedra,
+                                                          "hexahedra", formatCell<Hexahedron>));
+                    }
+                }
+                for (const DifferentialFeature& feature : features) {
+                    if (!feature.appliesTo(c)) continue;
+                    ++report.comparisons;
+                    QString detail = feature.check(c, expected.hexahedra);
+                    if (detail.isEmpty()) continue;
+                    DifferentialMismatch mismatch;
+                    mismatch.caseName = c.name;
+                    mismatch.path = feature.name;
+                    mismatch.threads = threads;
+                    mismatch.stage = "result";
+                    mismatch.detail = detail;
+                    report.mismatches.push_back(mismatch);
+                }
+            }
+        }
+        setThreadCount(previousThreads);
+        return report;
+    }
+} // namespace ReconstructionEngine
+
+#endif // DIFFERENTIAL_CHECK_H
@@ -0,0 +1,178 @@
+#ifndef ELL_GRAPH_H
+#define ELL_GRAPH_H
+
+#include <algorithm>
+#include <cstdint>
+#include "reconstruction_engine.h"
+#include "parallel.h"
+
+namespace ReconstructionEngine {
+    // The smallest power of two that is at least `n`.
+    constexpr int ellRowStride(int n, int stride = 1) { return stride >= n ? stride : ellRowStride(n, stride * 2); }
+
+    /**
+     * @class EllGraph
+     * @brief An ELLPACK adjacency graph: every row has exactly `Width` int slots, padded with -1.
+     *
+     * Hex-mesh vertices have at most six structural neighbors. Rows are laid out `Stride` ints
+     * apart (Width rounded up to a power of two) from a 64-byte aligned base, so every row lies
+     * inside one cache line; EllGraph6 spends 32 bytes on each 24-byte row. A membership test
+     * is a fixed-length, branch-free compare over all `Stride` ints of the row, padding
+     * included, which the compiler unrolls (and, for EllGraph6 too, turns into one 256-bit
+     * compare on AVX2). Rows with more neighbors keep the first `Width` in the slots and the
+     * rest in a small overflow table.
+     *
+     * Steps 2 and 3 read it directly through the hasVertex/hasEdge/forEachNeighbor overloads.
+     */
+    template <int Width>
+    class EllGraph {
+        static_assert(Width > 0 && Width * sizeof(int) <= 64, "a row must fit in a cache line");
+
+    public:
+        static const int Stride = ellRowStride(Width);
+
+        EllGraph() : m_slots(nullptr), m_vertexCount(0) {}
+
+        EllGraph(const AdjacencyGraph& adjGraph, int vertexCount) : m_slots(nullptr), m_vertexCount(0) {
+            resize(vertexCount);
+            std::vector<int> row;
+            for (int v = 0; v < vertexCount; ++v) {
+                auto it = adjGraph.find(v);
+                if (it == adjGraph.end()) continue;
+                row.assign(it->second.begin(), it->second.end());
+                setRow(v, row);
+            }
+        }
+
+        EllGraph(const EllGraph& other) : m_slots(nullptr), m_vertexCount(0) { *this = other; }
+
+        // Moving the storage keeps its buffer, so the aligned row pointer stays valid.
+        EllGraph(EllGraph&& other)
+            : m_storage(std::move(other.m_storage)), m_slots(other.m_slots), m_vertexCount(other.m_vertexCount),
+              m_overflow(std::move(other.m_overflow)) {
+            other.m_slots = nullptr;
+            other.m_vertexCount = 0;
+        }
+
+        EllGraph& operator=(EllGraph&& other) {
+            if (this == &other) return *this;
+            m_storage = std::move(other.m_storage);
+            m_slots = other.m_slots;
+            m_vertexCount = other.m_vertexCount;
+            m_overflow = std::move(other.m_overflow);
+            other.m_slots = nullptr;
+            other.m_vertexCount = 0;
+            return *this;
+        }
+
+        EllGraph& operator=(const EllGraph& other) {
+            if (this == &other) return *this;
+            resize(other.m_vertexCount);
+            std::copy(other.m_slots, other.m_slots + (size_t)m_vertexCount * Stride, m_slots);
+            m_overflow = other.m_overflow;
+            return *this;
+        }
+
+        // Empties the graph and sizes it for `vertexCount` rows with no neighbors.
+        void resize(int vertexCount) {
+            m_vertexCount = vertexCount;
+            // The base is 64-byte aligned and Stride divides 16 ints, so no row straddles two
+            // cache lines.
+            m_storage.assign((size_t)vertexCount * Stride + 64 / sizeof(int), -1);
+            uintptr_t address = reinterpret_cast<uintptr_t>(m_storage.data());
+            m_slots = m_storage.data() + ((64 - address % 64) % 64) / sizeof(int);
+            m_overflow.clear();
+        }
+
+        // Replaces the row of `v`. Rows of different vertices may be set from different threads
+        // as long as none of them overflows.
+        void setRow(int v, const std::vector<int>& neighbors) {
+            int* row = m_slots + (size_t)v * Stride;
+            std::fill(row, row + Width, -1);
+            for (size_t k = 0; k < neighbors.size() && k < (size_t)Width; ++k) row[k] = neighbors[k];
+            if (neighbors.size() > (size_t)Width) {
+                m_overflow[v].assign(neighbors.begin() + Width, neighbors.end());
+            } else if (!m_overflow.empty()) {
+                m_overflow.erase(v);
+            }
+        }
+
+        int vertexCount() const { return m_vertexCount; }
+        const int* row(int v) const { return m_slots + (size_t)v * Stride; }
+        bool hasOverflow() const { return !m_overflow.empty(); }
+
+        size_t memoryBytes() const {
+            size_t bytes = m_storage.capacity() * sizeof(int);
+            for (const auto& row : m_overflow) bytes += row.second.capacity() * sizeof(int) + sizeof(row);
+            return bytes;
+        }
+
+        // `to` must be a vertex (>= 0): the -1 padding beyond Width is compared too.
+        bool contains(int from, int to) const {
+            const int* entries = row(from);
+            bool found = false;
+            for (int s = 0; s < Stride; ++s) found |= entries[s] == to;
+            if (found || m_overflow.empty() || entries[Width - 1] < 0) return found;
+            auto it = m_overflow.find(from);
+            return it != m_overflow.end() && std::find(it->second.begin(), it->second.end(), to) != it->second.end();
+        }
+
+        template <typename Fn>
+        void forEach(int v, Fn fn) const {
+            const int* entries = row(v);
+            for (int s = 0; s < Width && entries[s] >= 0; ++s) fn(entries[s]);
+            if (m_overflow.empty() || entries[Width - 1] < 0) return;
+            auto it = m_overflow.find(v);
+            if (it != m_overflow.end()) {
+                for (int neighbor : it->second) fn(neighbor);
+            }
+        }
+
+    private:
+        std::vector<int> m_storage;
+        int* m_slots;
+        int m_vertexCount;
+        std::unordered_map<int, std::vector<int>> m_overflow;
+    };
+
+    using EllGraph6 = EllGraph<6>;
+    using EllGraph8 = EllGraph<8>;
+
+    template <int Width>
+    inline bool hasVertex(const EllGraph<Width>& graph, int v) { return v >= 0 && v < graph.vertexCount(); }
+
+    template <int Width>
+    inline bool hasEdge(const EllGraph<Width>& graph, int from, int to) {
+        return to >= 0 && hasVertex(graph, from) && graph.contains(from, to);
+    }
+
+    template <int Width, typename Fn>
+    inline void forEachNeighbor(const EllGraph<Width>& graph, int v, Fn fn) {
+        if (hasVertex(graph, v)) graph.forEach(v, fn);
+    }
+
+    /**
+     * @brief Step 1 straight into an EllGraph; rows are filled nearest neighbor first.
+     */
+    template <int Width>
+    inline EllGraph<Width> buildEllAdjacencyGraph(const std::vector<MeshPoint>& points) {
+        EllGraph<Width> graph;
+        graph.resize((int)points.size());
+        std::vector<std::vector<int>> overflowing(points.size());
+        parallelFor(0, (int)points.size(), [&](int i) {
+            std::vector<int> nearest = nearestNeighbors(points, i);
+            if (nearest.size() > (size_t)Width) {
+                overflowing[i].swap(nearest);
+            } else {
+                graph.setRow(i, nearest);
+            }
+        }, 16);
+        // Overflow rows touch the shared table, so they are stored afterwards on one thread.
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (!overflowing[i].empty()) graph.setRow((int)i, overflowing[i]);
+        }
+        return graph;
+    }
+} // namespace ReconstructionEngine
+
+#endif // ELL_GRAPH_H
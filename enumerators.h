@@ -0,0 +1,248 @@
+#ifndef ENUMERATORS_H
+#define ENUMERATORS_H
+
+#include <iterator>
+#include <map>
+#include <QHash>
+#include "reconstruction_engine.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @class ResultRange
+     * @brief Adapts an enumerator with `bool next(T&)` to a single-pass range for range-for loops.
+     */
+    template <typename Enumerator, typename T>
+    class ResultRange {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            iterator() : m_source(nullptr) {}
+            explicit iterator(Enumerator* source) : m_source(source) { ++*this; }
+
+            const T& operator*() const { return m_current; }
+            const T* operator->() const { return &m_current; }
+            iterator& operator++() {
+                if (m_source && !m_source->next(m_current)) m_source = nullptr;
+                return *this;
+            }
+            bool operator==(const iterator& other) const { return m_source == other.m_source; }
+            bool operator!=(const iterator& other) const { return m_source != other.m_source; }
+
+        private:
+            Enumerator* m_source;
+            T m_current;
+        };
+
+        explicit ResultRange(Enumerator enumerator) : m_enumerator(std::move(enumerator)) {}
+        iterator begin() { return iterator(&m_enumerator); }
+        iterator end() { return iterator(); }
+
+    private:
+        Enumerator m_enumerator;
+    };
+
+    /**
+     * @class FaceEnumerator
+     * @brief Lazily yields the faces of Step 2, in the same order and orientation as findValidFaces.
+     *
+     * The search state is kept between calls to next(), so no face list is built. A face can
+     * only be found again from one of its own vertices, so its dedup key is dropped once the
+     * search has moved past its highest vertex index; only keys near the search front are held.
+     */
+    class FaceEnumerator {
+    public:
+        FaceEnumerator(const std::vector<MeshPoint>& points, const AdjacencyGraph& adjGraph,
+                       const FaceTolerances& tolerances = FaceTolerances())
+            : m_points(&points), m_adjGraph(&adjGraph), m_tolerances(tolerances), m_p0(-1), m_i(0), m_j(0), m_inCycle(false) {}
+
+        bool next(QuadFace& face) {
+            const AdjacencyGraph& adjGraph = *m_adjGraph;
+            for (;;) {
+                if (m_inCycle) {
+                    // Resume the scan over the neighbors p2 of p1.
+                    int p1_idx = m_neighbors[m_i];
+                    int p3_idx = m_neighbors[m_j];
+                    const std::unordered_set<int>& p3_row = adjGraph.at(p3_idx);
+                    while (m_p2 != m_p2End) {
+                        int p2_idx = *m_p2++;
+                        if (p2_idx == m_p0 || !p3_row.count(p2_idx)) continue;
+                        QuadFace potentialFace = {m_p0, p1_idx, p2_idx, p3_idx};
+                        if (!isStructuralFace(*m_points, potentialFace, m_tolerances)) continue;
+
+                        QVector<int> sortedFace = {m_p0, p1_idx, p2_idx, p3_idx};
+                        std::sort(sortedFace.begin(), sortedFace.end());
+                        if (m_uniqueFaces.contains(sortedFace)) continue;
+                        m_uniqueFaces.insert(sortedFace);
+                        m_retireAt[sortedFace[3]].push_back(sortedFace);
+                        face = potentialFace;
+                        return true;
+                    }
+                    m_inCycle = false;
+                    ++m_j;
+                }
+                if (!advancePair()) return false;
+            }
+        }
+
+    private:
+        // Moves to the next (p1, p3) neighbor pair of p0, or to the next p0; false when done.
+        bool advancePair() {
+            const AdjacencyGraph& adjGraph = *m_adjGraph;
+            for (;;) {
+                if (m_j >= m_neighbors.size()) {
+                    ++m_i;
+                    m_j = m_i + 1;
+                }
+                if (m_i + 1 >= m_neighbors.size() || m_p0 < 0) {
+                    if (!advancePoint()) return false;
+                    continue;
+                }
+                int p1_idx = m_neighbors[m_i];
+                int p3_idx = m_neighbors[m_j];
+                if (!adjGraph.count(p1_idx) || !adjGraph.count(p3_idx)) {
+                    ++m_j;
+                    continue;
+                }
+                m_p2 = adjGraph.at(p1_idx).begin();
+                m_p2End = adjGraph.at(p1_idx).end();
+                m_inCycle = true;
+                return true;
+            }
+        }
+
+        bool advancePoint() {
+            const AdjacencyGraph& adjGraph = *m_adjGraph;
+            do {
+                // Faces whose highest vertex is behind the search front cannot be found again.
+                auto retired = m_retireAt.find(m_p0);
+                if (retired != m_retireAt.end()) {
+                    for (const QVector<int>& key : retired->second) m_uniqueFaces.remove(key);
+                    m_retireAt.erase(retired);
+                }
+                if (++m_p0 >= (int)m_points->size()) return false;
+            } while (!adjGraph.count(m_p0));
+
+            m_neighbors.assign(adjGraph.at(m_p0).begin(), adjGraph.at(m_p0).end());
+            m_i = 0;
+            m_j = 1;
+            return true;
+        }
+
+        const std::vector<MeshPoint>* m_points;
+        const AdjacencyGraph* m_adjGraph;
+        FaceTolerances m_tolerances;
+        QSet<QVector<int>> m_uniqueFaces;
+        std::map<int, std::vector<QVector<int>>> m_retireAt;
+
+        int m_p0;
+        std::vector<int> m_neighbors;
+        size_t m_i, m_j;
+        bool m_inCycle;
+        std::unordered_set<int>::const_iterator m_p2, m_p2End;
+    };
+
+    /**
+     * @class HexahedronEnumerator
+     * @brief Lazily yields the hexahedra of Step 3, in the same order as buildHexahedra.
+     *
+     * Face pairs are visited one at a time. Instead of remembering every emitted cell, a
+     * candidate is only yielded from the first face pair that produces it: the faces lying on
+     * its eight corners are looked up, and any earlier pair among them means it was already
+     * yielded. Only a face index is kept, never the list of cells.
+     */
+    class HexahedronEnumerator {
+    public:
+        HexahedronEnumerator(std::vector<QuadFace> faces, const AdjacencyGraph& adjGraph)
+            : m_faces(std::move(faces)), m_adjGraph(&adjGraph), m_i(0), m_j(0) {
+            for (size_t f = 0; f < m_faces.size(); ++f) m_faceIndex.insert(sortedKey(m_faces[f]), (int)f);
+        }
+
+        bool next(Hexahedron& hex) {
+            while (m_i < m_faces.size()) {
+                if (++m_j >= m_faces.size()) {
+                    ++m_i;
+                    m_j = m_i;
+                    continue;
+                }
+                if (!pairOppositeFaces(m_faces[m_i], m_faces[m_j], *m_adjGraph, hex)) continue;
+                if (!producedEarlier(hex)) return true;
+            }
+            return false;
+        }
+
+    private:
+        static QVector<int> sortedKey(const QuadFace& face) {
+            QVector<int> key = {face[0], face[1], face[2], face[3]};
+            std::sort(key.begin(), key.end());
+            return key;
+        }
+
+        // True if a face pair before (m_i, m_j) also yields a cell on the same eight corners.
+        bool producedEarlier(const Hexahedron& hex) {
+            Hexahedron corners = hex;
+            std::sort(corners.begin(), corners.end());
+            // Every split of the corners into two faces: the lowest corner plus three others, and the rest.
+            for (int x = 1; x < 8; ++x) {
+                for (int y = x + 1; y < 8; ++y) {
+                    for (int z = y + 1; z < 8; ++z) {
+                        QVector<int> keyA = {corners[0], corners[x], corners[y], corners[z]};
+                        QVector<int> keyB;
+                        for (int k = 1; k < 8; ++k) {
+                            if (k != x && k != y && k != z) keyB.append(corners[k]);
+                        }
+                        auto a = m_faceIndex.find(keyA);
+                        auto b = m_faceIndex.find(keyB);
+                        if (a == m_faceIndex.end() || b == m_faceIndex.end()) continue;
+
+                        size_t first = (size_t)std::min(a.value(), b.value());
+                        size_t second = (size_t)std::max(a.value(), b.value());
+                        if (first > m_i || (first == m_i && second >= m_j)) continue;
+                        Hexahedron earlier;
+                        if (pairOppositeFaces(m_faces[first], m_faces[second], *m_adjGraph, earlier)) return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        std::vector<QuadFace> m_faces;
+        const AdjacencyGraph* m_adjGraph;
+        QHash<QVector<int>, int> m_faceIndex;
+        size_t m_i, m_j;
+    };
+
+    /**
+     * @brief Lazily enumerates the valid faces (Step 2): `for (const QuadFace& f : enumerateFaces(points, graph))`.
+     *
+     * The points and graph must outlive the returned range.
+     */
+    inline ResultRange<FaceEnumerator, QuadFace> enumerateFaces(const std::vector<MeshPoint>& points, const AdjacencyGraph& adjGraph,
+                                                                const FaceTolerances& tolerances = FaceTolerances()) {
+        return ResultRange<FaceEnumerator, QuadFace>(FaceEnumerator(points, adjGraph, tolerances));
+    }
+
+    /**
+     * @brief Lazily enumerates the hexahedra (Step 3) built from a face list.
+     */
+    inline ResultRange<HexahedronEnumerator, Hexahedron> enumerateHexahedra(std::vector<QuadFace> faces, const AdjacencyGraph& adjGraph) {
+        return ResultRange<HexahedronEnumerator, Hexahedron>(HexahedronEnumerator(std::move(faces), adjGraph));
+    }
+
+    /**
+     * @brief Lazily enumerates the hexahedra of a point cloud; only the faces are materialized.
+     */
+    inline ResultRange<HexahedronEnumerator, Hexahedron> enumerateHexahedra(const std::vector<MeshPoint>& points, const AdjacencyGraph& adjGraph,
+                                                                            const FaceTolerances& tolerances = FaceTolerances()) {
+        std::vector<QuadFace> faces;
+        for (const QuadFace& face : enumerateFaces(points, adjGraph, tolerances)) faces.push_back(face);
+        return enumerateHexahedra(std::move(faces), adjGraph);
+    }
+} // namespace ReconstructionEngine
+
+#endif // ENUMERATORS_H
@@ -0,0 +1,101 @@
+#ifndef EXTRUSION_H
+#define EXTRUSION_H
+
+#include "reconstruction_engine.h"
+#include "layer_streaming.h"
+#include "parallel.h"
+#include "spatial_index.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @struct ExtrusionResult
+     * @brief Output of the extrusion fast path.
+     */
+    struct ExtrusionResult {
+        std::vector<QuadFace> baseFaces;     // Quad faces of the first layer (indices into layer 0).
+        std::vector<Hexahedron> hexahedra;   // Cells indexed into the concatenation of all layers.
+        int inconsistentLayers = 0;          // Layers whose nearest-neighbor matching was not one-to-one.
+    };
+
+    /**
+     * @brief For every point of `from`, finds the index of its nearest point in `to`.
+     */
+    inline std::vector<int> matchLayerPoints(const std::vector<MeshPoint>& from, const std::vector<MeshPoint>& to) {
+        std::vector<int> match(from.size(), -1);
+        UniformGridIndex index(to);
+        parallelFor(0, (int)from.size(), [&](int i) {
+            match[i] = index.nearest(from[i].pos);
+        });
+        return match;
+    }
+
+    /**
+     * @brief Fast path for swept meshes where every layer shares the quad topology of the first.
+     *
+     * Steps 1-2 run on the first layer only. Each following layer is matched point-by-point to
+     * the previous one by nearest neighbor, and the hexahedra are emitted by index
+     * correspondence, so the O(F^2) face pairing of Step 3 is skipped entirely.
+     */
+    inline ExtrusionResult reconstructExtrusion(const std::vector<std::vector<MeshPoint>>& layers) {
+        ExtrusionResult result;
+        if (layers.size() < 2) return result;
+
+        // Steps 1-2 on the base layer, with the link to the layer above taken out of each constraint.
+        std::vector<MeshPoint> base;
+        base.reserve(layers[0].size());
+        for (const MeshPoint& p : layers[0]) {
+            base.push_back({p.pos, inLayerNeighborBudget(p, false, true) });
+        }
+        AdjacencyGraph baseGraph = buildAdjacencyGraph(base);
+        result.baseFaces = findValidFaces(base, baseGraph);
+
+        // `current[i]` is the position of base point i within the current layer.
+        std::vector<int> current(layers[0].size());
+        for (size_t i = 0; i < current.size(); ++i) current[i] = (int)i;
+
+        int offset = 0;
+        result.hexahedra.reserve(result.baseFaces.size() * (layers.size() - 1));
+        for (size_t k = 1; k < layers.size(); ++k) {
+            std::vector<int> match = matchLayerPoints(layers[k - 1], layers[k]);
+            std::vector<char> taken(layers[k].size(), 0);
+            bool oneToOne = true;
+            for (int m : match) {
+                if (m < 0 || taken[m]) { oneToOne = false; continue; }
+                taken[m] = 1;
+            }
+            if (!oneToOne) ++result.inconsistentLayers;
+
+            int nextOffset = offset + (int)layers[k - 1].size();
+            std::vector<int> next(current.size(), -1);
+            for (size_t i = 0; i < current.size(); ++i) {
+                if (current[i] >= 0) next[i] = match[current[i]];
+            }
+
+            for (const QuadFace& face : result.baseFaces) {
+                Hexahedron hex;
+                bool complete = true;
+                for (int c = 0; c < 4 && complete; ++c) {
+                    if (current[face[c]] < 0 || next[face[c]] < 0) complete = false;
+                    else {
+                        hex[c] = offset + current[face[c]];
+                        hex[c + 4] = nextOffset + next[face[c]];
+                    }
+                }
+                if (!complete) continue;
+                if (!oneToOne) {
+                    // Two corners collapsed onto the same point; the cell is degenerate.
+                    Hexahedron sorted = hex;
+                    std::sort(sorted.begin(), sorted.end());
+                    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) continue;
+                }
+                result.hexahedra.push_back(hex);
+            }
+
+            current.swap(next);
+            offset = nextOffset;
+        }
+        return result;
+    }
+} // namespace ReconstructionEngine
+
+#endif // EXTRUSION_H
@@ -0,0 +1,218 @@
+#ifndef FRAME_SERIES_H
+#define FRAME_SERIES_H
+
+#include "reconstruction_engine.h"
+#include "parallel.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @brief Re-checks a batch of faces against (possibly moved) point positions.
+     *
+     * Returns one flag per face, set when the face still passes the coplanarity and diagonal
+     * tests of isStructuralFace. Corners are gathered into structure-of-arrays blocks so the
+     * arithmetic runs as branch-free loops the compiler can vectorize.
+     */
+    inline std::vector<char> revalidateFaces(const std::vector<MeshPoint>& points, const std::vector<QuadFace>& faces,
+                                             const FaceTolerances& tolerances = FaceTolerances()) {
+        const int kBlock = 64;
+        std::vector<char> valid(faces.size(), 0);
+        int blocks = ((int)faces.size() + kBlock - 1) / kBlock;
+
+        parallelFor(0, blocks, [&](int block) {
+            float x[4][kBlock], y[4][kBlock], z[4][kBlock];
+            char inRange[kBlock];
+            int first = block * kBlock;
+            int count = std::min(kBlock, (int)faces.size() - first);
+
+            for (int f = 0; f < count; ++f) {
+                const QuadFace& face = faces[first + f];
+                inRange[f] = 1;
+                for (int c = 0; c < 4; ++c) {
+                    int idx = face[c];
+                    bool ok = idx >= 0 && idx < (int)points.size();
+                    const Vector3 p = ok ? points[idx].pos : Vector3();
+                    x[c][f] = p.x(); y[c][f] = p.y(); z[c][f] = p.z();
+                    if (!ok) inRange[f] = 0;
+                }
+            }
+
+            for (int f = 0; f < count; ++f) {
+                float ax = x[1][f] - x[0][f], ay = y[1][f] - y[0][f], az = z[1][f] - z[0][f];
+                float bx = x[2][f] - x[0][f], by = y[2][f] - y[0][f], bz = z[2][f] - z[0][f];
+                float cx = x[3][f] - x[0][f], cy = y[3][f] - y[0][f], cz = z[3][f] - z[0][f];
+                float volume = ax * (by * cz - bz * cy) + ay * (bz * cx - bx * cz) + az * (bx * cy - by * cx);
+
+                float e01 = ax * ax + ay * ay + az * az;
+                float dx12 = x[2][f] - x[1][f], dy12 = y[2][f] - y[1][f], dz12 = z[2][f] - z[1][f];
+                float e12 = dx12 * dx12 + dy12 * dy12 + dz12 * dz12;
+                float dx23 = x[3][f] - x[2][f], dy23 = y[3][f] - y[2][f], dz23 = z[3][f] - z[2][f];
+                float e23 = dx23 * dx23 + dy23 * dy23 + dz23 * dz23;
+                float e30 = cx * cx + cy * cy + cz * cz;
+                float d02 = bx * bx + by * by + bz * bz;
+                float dx13 = x[3][f] - x[1][f], dy13 = y[3][f] - y[1][f], dz13 = z[3][f] - z[1][f];
+                float d13 = dx13 * dx13 + dy13 * dy13 + dz13 * dz13;
+
+                float maxEdge = std::max(std::max(e01, e12), std::max(e23, e30)) * tolerances.diagonalRatio;
+                valid[first + f] = (char)(inRange[f] & (std::abs(volume) < tolerances.coplanarity) & (d02 > maxEdge) & (d13 > maxEdge));
+            }
+        }, 4);
+        return valid;
+    }
+
+    /**
+     * @brief Returns one flag per hexahedron, set when all six of its faces are still structural.
+     */
+    inline std::vector<char> revalidateHexahedra(const std::vector<MeshPoint>& points, const std::vector<Hexahedron>& hexahedra,
+                                                 const FaceTolerances& tolerances = FaceTolerances()) {
+        std::vector<QuadFace> hexFaces(hexahedra.size() * 6);
+        for (size_t h = 0; h < hexahedra.size(); ++h) {
+            for (int f = 0; f < 6; ++f) {
+                for (int c = 0; c < 4; ++c) hexFaces[h * 6 + f][c] = hexahedra[h][kHexahedronFaces[f][c]];
+            }
+        }
+        std::vector<char> faceValid = revalidateFaces(points, hexFaces, tolerances);
+
+        std::vector<char> valid(hexahedra.size(), 1);
+        for (size_t h = 0; h < hexahedra.size(); ++h) {
+            for (int f = 0; f < 6; ++f) valid[h] &= faceValid[h * 6 + f];
+        }
+        return valid;
+    }
+
+    /**
+     * @struct FrameUpdateSummary
+     * @brief What happened while advancing a FrameSeriesReconstructor by one frame.
+     */
+    struct FrameUpdateSummary {
+        bool fullReconstruction = false; // The frame was reconstructed from scratch.
+        int failedHexahedra = 0;         // Hexahedra that no longer passed validation.
+        int rebuiltPoints = 0;           // Points whose neighborhood was reconstructed locally.
+        int hexahedra = 0;               // Hexahedra in the mesh after the update.
+    };
+
+    /**
+     * @class FrameSeriesReconstructor
+     * @brief Reconstructs a deforming body across simulation frames, reusing the topology.
+     *
+     * The first frame runs Steps 1-3 in full. Each later frame (same points, new positions)
+     * only re-validates the faces of the existing hexahedra; where a hexahedron fails, the graph
+     * and cells are rebuilt locally around its corners and merged back. Every face test, both
+     * when validating and when rebuilding, uses the tolerances given at construction.
+     */
+    class FrameSeriesReconstructor {
+    public:
+        explicit FrameSeriesReconstructor(const FaceTolerances& tolerances = FaceTolerances()) : m_tolerances(tolerances) {}
+
+        FrameUpdateSummary reset(const std::vector<MeshPoint>& firstFrame) {
+            m_points = firstFrame;
+            m_adjGraph = buildAdjacencyGraph(m_points);
+            m_hexahedra = buildHexahedra(findValidFaces(m_points, m_adjGraph, m_tolerances), m_adjGraph);
+
+            FrameUpdateSummary summary;
+            summary.fullReconstruction = true;
+            summary.rebuiltPoints = (int)m_points.size();
+            summary.hexahedra = (int)m_hexahedra.size();
+            return summary;
+        }
+
+        FrameUpdateSummary advance(const std::vector<MeshPoint>& frame) {
+            if (frame.size() != m_points.size() || m_points.empty()) return reset(frame);
+            m_points = frame;
+
+            FrameUpdateSummary summary;
+            std::vector<char> hexValid = revalidateHexahedra(m_points, m_hexahedra, m_tolerances);
+            std::vector<char> inRegion(m_points.size(), 0);
+            for (size_t h = 0; h < m_hexahedra.size(); ++h) {
+                if (hexValid[h]) continue;
+                ++summary.failedHexahedra;
+                for (int idx : m_hexahedra[h]) inRegion[idx] = 1;
+            }
+            if (summary.failedHexahedra == 0) {
+                summary.hexahedra = (int)m_hexahedra.size();
+                return summary;
+            }
+
+            // Refresh the graph rows of the failed corners and their one-ring.
+            std::vector<char> ring1 = expandByOneRing(inRegion);
+            std::vector<int> rebuilt;
+            for (size_t i = 0; i < ring1.size(); ++i) {
+                if (ring1[i]) rebuilt.push_back((int)i);
+            }
+            std::vector<std::vector<int>> rows(rebuilt.size());
+            parallelFor(0, (int)rebuilt.size(), [&](int r) {
+                rows[r] = nearestNeighbors(m_points, rebuilt[r]);
+            }, 16);
+            for (size_t r = 0; r < rebuilt.size(); ++r) {
+                m_adjGraph[rebuilt[r]] = std::unordered_set<int>(rows[r].begin(), rows[r].end());
+            }
+            summary.rebuiltPoints = (int)rebuilt.size();
+
+            // Faces touching the one-ring can only be discovered from the two-ring.
+            std::vector<char> ring2 = expandByOneRing(ring1);
+            std::vector<QuadFace> localFaces;
+            QSet<QVector<int>> uniqueFaces;
+            for (int p0 = 0; p0 < (int)ring2.size(); ++p0) {
+                if (ring2[p0]) collectFacesFrom(p0, m_points, m_adjGraph, uniqueFaces, localFaces, m_tolerances);
+            }
+            localFaces.erase(std::remove_if(localFaces.begin(), localFaces.end(), [&](const QuadFace& face) {
+                return !touches(face, ring1);
+            }), localFaces.end());
+
+            // Keep the cells away from the failure and replace the rest with a local rebuild.
+            std::vector<Hexahedron> hexahedra;
+            QSet<QVector<int>> uniqueHexes;
+            for (size_t h = 0; h < m_hexahedra.size(); ++h) {
+                if (hexValid[h] && !touches(m_hexahedra[h], inRegion)) addUnique(m_hexahedra[h], uniqueHexes, hexahedra);
+            }
+            for (const Hexahedron& hex : buildHexahedra(localFaces, m_adjGraph)) {
+                if (touches(hex, inRegion)) addUnique(hex, uniqueHexes, hexahedra);
+            }
+            m_hexahedra.swap(hexahedra);
+
+            summary.hexahedra = (int)m_hexahedra.size();
+            return summary;
+        }
+
+        const std::vector<MeshPoint>& points() const { return m_points; }
+        const AdjacencyGraph& adjacencyGraph() const { return m_adjGraph; }
+        const std::vector<Hexahedron>& hexahedra() const { return m_hexahedra; }
+        const FaceTolerances& tolerances() const { return m_tolerances; }
+
+    private:
+        template <typename Cell>
+        static bool touches(const Cell& cell, const std::vector<char>& mask) {
+            for (int idx : cell) {
+                if (mask[idx]) return true;
+            }
+            return false;
+        }
+
+        static void addUnique(const Hexahedron& hex, QSet<QVector<int>>& uniqueHexes, std::vector<Hexahedron>& out) {
+            QVector<int> sortedHex(8);
+            for (int k = 0; k < 8; ++k) sortedHex[k] = hex[k];
+            std::sort(sortedHex.begin(), sortedHex.end());
+            if (uniqueHexes.contains(sortedHex)) return;
+            uniqueHexes.insert(sortedHex);
+            out.push_back(hex);
+        }
+
+        // Adds every point linked to the mask by a graph edge in either direction.
+        std::vector<char> expandByOneRing(const std::vector<char>& mask) const {
+            std::vector<char> expanded = mask;
+            for (const auto& row : m_adjGraph) {
+                for (int neighbor : row.second) {
+                    if (mask[row.first]) expanded[neighbor] = 1;
+                    if (mask[neighbor]) expanded[row.first] = 1;
+                }
+            }
+            return expanded;
+        }
+
+        FaceTolerances m_tolerances;
+        std::vector<MeshPoint> m_points;
+        AdjacencyGraph m_adjGraph;
+        std::vector<Hexahedron> m_hexahedra;
+    };
+} // namespace ReconstructionEngine
+
+#endif // FRAME_SERIES_H
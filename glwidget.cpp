@@ -3,7 +3,7 @@
 #include <QPainter>
 
 GLWidget::GLWidget(QWidget *parent)
-    : QOpenGLWidget(parent), m_zoom(1.0f) {
+    : QOpenGLWidget(parent), m_zoom(1.0f), m_lastFrameTimeMs(0.0), m_averageFrameTimeMs(0.0), m_frameCount(0) {
     // Initialize the camera's view matrix, moving it back from the origin.
     m_viewMatrix.translate(0.0f, 0.0f, -5.0f);
 }
@@ -54,6 +54,7 @@ QPoint GLWidget::project(const QMatrix4x4 &mvp, const QVector3D &point3d) {
 }
 
 void GLWidget::paintGL() {
+    m_frameTimer.start();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Set up projection matrix
@@ -82,6 +83,11 @@ void GLWidget::paintGL() {
             }
         }
     }
+
+    // Exponential average over roughly the last ten frames.
+    m_lastFrameTimeMs = m_frameTimer.nsecsElapsed() / 1e6;
+    m_averageFrameTimeMs = m_frameCount == 0 ? m_lastFrameTimeMs : 0.9 * m_averageFrameTimeMs + 0.1 * m_lastFrameTimeMs;
+    ++m_frameCount;
 }
 
 // --- Drawing Functions ---
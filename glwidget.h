@@ -3,6 +3,7 @@
 
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
+#include <QElapsedTimer>
 #include <QMatrix4x4>
 #include <QMouseEvent>
 #include <QWheelEvent>
@@ -22,6 +23,12 @@ public:
     void setHexahedra(const std::vector<Hexahedron>& hexahedra);
     void reset();
 
+    // CPU time of the most recent paintGL call and an exponential average over roughly the
+    // last ten frames, in milliseconds. frameCount() is the total since construction.
+    double lastFrameTimeMs() const { return m_lastFrameTimeMs; }
+    double averageFrameTimeMs() const { return m_averageFrameTimeMs; }
+    int frameCount() const { return m_frameCount; }
+
 protected:
     // --- OpenGL Event Handlers ---
     void initializeGL() override;
@@ -54,6 +61,12 @@ private:
     QVector2D m_lastMousePos;
     float m_zoom;
     QQuaternion m_rotation;
+
+    // --- Frame Timing ---
+    QElapsedTimer m_frameTimer;
+    double m_lastFrameTimeMs;
+    double m_averageFrameTimeMs;
+    int m_frameCount;
 };
 
 #endif // GLWIDGET_H
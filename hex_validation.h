@@ -0,0 +1,158 @@
+#ifndef HEX_VALIDATION_H
+#define HEX_VALIDATION_H
+
+#include <QStringList>
+#include "reconstruction_engine.h"
+#include "parallel.h"
+#include "spatial_index.h"
+
+namespace ReconstructionEngine {
+    // Defects a hexahedron can be flagged with; combined as a bit mask.
+    enum HexDefect {
+        HexIndexOutOfRange   = 1 << 0, // A corner does not refer to an input point.
+        HexRepeatedCorner    = 1 << 1, // Two corners refer to the same point.
+        HexMissingEdge       = 1 << 2, // An edge is not present in the adjacency graph.
+        HexNonPlanarFace     = 1 << 3, // A face fails the coplanarity test.
+        HexFailsDiagonalTest = 1 << 4  // A face has a diagonal no longer than one of its edges.
+    };
+
+    /**
+     * @struct HexValidationFailure
+     * @brief A hexahedron that failed validation, with the defects found.
+     */
+    struct HexValidationFailure {
+        int hexIndex;
+        int defects;       // Bit mask of HexDefect values.
+        int firstBadEdge;  // Index into kHexahedronEdges of the first missing edge, or -1.
+        int firstBadFace;  // Index into kHexahedronFaces of the first failing face, or -1.
+    };
+
+    /**
+     * @struct HexValidationReport
+     * @brief Result of validating a hexahedral mesh against its points.
+     */
+    struct HexValidationReport {
+        int checkedHexahedra = 0;
+        std::vector<HexValidationFailure> failures; // Ordered by hexIndex.
+
+        bool isValid() const { return failures.empty(); }
+    };
+
+    inline QStringList describeHexDefects(int defects) {
+        QStringList reasons;
+        if (defects & HexIndexOutOfRange) reasons << "index out of range";
+        if (defects & HexRepeatedCorner) reasons << "repeated corner";
+        if (defects & HexMissingEdge) reasons << "edge missing from graph";
+        if (defects & HexNonPlanarFace) reasons << "non-planar face";
+        if (defects & HexFailsDiagonalTest) reasons << "face fails diagonal test";
+        return reasons;
+    }
+
+    // True if a and b are linked in either direction.
+    inline bool areAdjacent(const AdjacencyGraph& adjGraph, int a, int b) {
+        auto rowA = adjGraph.find(a);
+        if (rowA != adjGraph.end() && rowA->second.count(b)) return true;
+        auto rowB = adjGraph.find(b);
+        return rowB != adjGraph.end() && rowB->second.count(a);
+    }
+
+    /**
+     * @brief Checks a single hexahedron; returns a HexDefect mask (0 if valid). Faces are
+     * tested with `tolerances`, as in Step 2.
+     */
+    inline int validateHexahedron(const std::vector<MeshPoint>& points, const Hexahedron& hex, const AdjacencyGraph& adjGraph,
+                                  int* firstBadEdge = nullptr, int* firstBadFace = nullptr,
+                                  const FaceTolerances& tolerances = FaceTolerances()) {
+        if (firstBadEdge) *firstBadEdge = -1;
+        if (firstBadFace) *firstBadFace = -1;
+
+        for (int idx : hex) {
+            if (idx < 0 || idx >= (int)points.size()) return HexIndexOutOfRange;
+        }
+        Hexahedron sorted = hex;
+        std::sort(sorted.begin(), sorted.end());
+        if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) return HexRepeatedCorner;
+
+        int defects = 0;
+        for (int e = 0; e < 12; ++e) {
+            if (!areAdjacent(adjGraph, hex[kHexahedronEdges[e][0]], hex[kHexahedronEdges[e][1]])) {
+                if (!(defects & HexMissingEdge) && firstBadEdge) *firstBadEdge = e;
+                defects |= HexMissingEdge;
+            }
+        }
+        for (int f = 0; f < 6; ++f) {
+            QuadFace face;
+            for (int c = 0; c < 4; ++c) face[c] = hex[kHexahedronFaces[f][c]];
+            int faceDefects = 0;
+            if (!arePointsCoplanar(points, face, tolerances.coplanarity)) faceDefects |= HexNonPlanarFace;
+            if (!passesDiagonalTest(points, face, tolerances.diagonalRatio)) faceDefects |= HexFailsDiagonalTest;
+            if (faceDefects && !(defects & (HexNonPlanarFace | HexFailsDiagonalTest)) && firstBadFace) *firstBadFace = f;
+            defects |= faceDefects;
+        }
+        return defects;
+    }
+
+    /**
+     * @brief Validates an externally supplied hexahedral mesh against a given adjacency graph.
+     *
+     * Every edge must exist in the graph (in either direction) and every face must pass the
+     * coplanarity and diagonal tests of Step 2 under `tolerances`; pass the ones the mesh was
+     * built with. Corners follow the buildHexahedra convention,
+     * which is also VTK's: 0-3 and 4-7 are opposite faces, corner k+4 is linked to corner k.
+     * Hexahedra are checked in parallel.
+     */
+    inline HexValidationReport validateHexMesh(const std::vector<MeshPoint>& points, const std::vector<Hexahedron>& hexahedra,
+                                               const AdjacencyGraph& adjGraph, const FaceTolerances& tolerances = FaceTolerances()) {
+        HexValidationReport report;
+        report.checkedHexahedra = (int)hexahedra.size();
+
+        std::vector<HexValidationFailure> results(hexahedra.size());
+        parallelFor(0, (int)hexahedra.size(), [&](int h) {
+            HexValidationFailure& result = results[h];
+            result.hexIndex = h;
+            result.defects = validateHexahedron(points, hexahedra[h], adjGraph, &result.firstBadEdge, &result.firstBadFace, tolerances);
+        }, 256);
+
+        for (const HexValidationFailure& result : results) {
+            if (result.defects) report.failures.push_back(result);
+        }
+        return report;
+    }
+
+    /**
+     * @brief Validates a hexahedral mesh against its points alone.
+     *
+     * The kNN rows of Step 1 are computed, in parallel, only for the points the mesh refers to,
+     * which is all the edge check needs; no faces are searched and no cells are paired. Each row
+     * is searched in the grid cells around its point (see nearestNeighbors with a
+     * UniformGridIndex), so the cost grows about linearly with the mesh instead of
+     * quadratically like Step 1.
+     */
+    inline HexValidationReport validateHexMesh(const std::vector<MeshPoint>& points, const std::vector<Hexahedron>& hexahedra,
+                                               const FaceTolerances& tolerances = FaceTolerances()) {
+        std::vector<char> used(points.size(), 0);
+        for (const Hexahedron& hex : hexahedra) {
+            for (int idx : hex) {
+                if (idx >= 0 && idx < (int)points.size()) used[idx] = 1;
+            }
+        }
+        std::vector<int> usedPoints;
+        for (size_t i = 0; i < used.size(); ++i) {
+            if (used[i]) usedPoints.push_back((int)i);
+        }
+
+        UniformGridIndex index(points);
+        std::vector<std::vector<int>> rows(usedPoints.size());
+        parallelFor(0, (int)usedPoints.size(), [&](int r) {
+            rows[r] = nearestNeighbors(points, index, usedPoints[r]);
+        }, 64);
+
+        AdjacencyGraph adjGraph;
+        for (size_t r = 0; r < usedPoints.size(); ++r) {
+            adjGraph[usedPoints[r]] = std::unordered_set<int>(rows[r].begin(), rows[r].end());
+        }
+        return validateHexMesh(points, hexahedra, adjGraph, tolerances);
+    }
+} // namespace ReconstructionEngine
+
+#endif // HEX_VALIDATION_H
@@ -0,0 +1,682 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include "point_io.h"
+#include "parameter_sweep.h"
+#include "batch_runner.h"
+#include "concurrent_key_set.h"
+#include "scaling_benchmark.h"
+#include "differential_check.h"
+#include "memory_accounting.h"
+#include "perf_counters.h"
+#include "preview_reconstruction.h"
+#include "region_reconstruction.h"
+
+using namespace ReconstructionEngine;
+
+namespace {
+
+// Parses a comma-separated list of numbers such as "1e-4,1e-3,1e-2".
+bool parseFloatList(const QString& text, std::vector<float>& values) {
+    values.clear();
+    for (const QString& item : text.split(',')) {
+        if (item.trimmed().isEmpty()) continue;
+        bool ok = false;
+        values.push_back(item.trimmed().toFloat(&ok));
+        if (!ok) return false;
+    }
+    return !values.empty();
+}
+
+bool loadPointsOrReport(const QString& path, std::vector<MeshPoint>& points) {
+    QString error;
+    if (loadPointFile(path, points, &error)) return true;
+    QTextStream(stderr) << error << '\n';
+    return false;
+}
+
+// One progress line on stderr, e.g. "# step3 42.1% of 9485190, eta 12 s". It runs on the
+// monitor thread and must not allocate, since a --memory-limit ceiling would throw there.
+void printProgress(const ProgressSample& sample) {
+    if (!sample.stage) return;
+    char eta[32] = "";
+    if (sample.etaSeconds() >= 0.0) std::snprintf(eta, sizeof(eta), ", eta %.0f s", sample.etaSeconds());
+    std::fprintf(stderr, "# %s %.1f%% of %llu%s\n", sample.stage, 100.0 * sample.fraction(),
+                 (unsigned long long)sample.total, eta);
+}
+
+// The resident half of --memory-limit. The ceiling only sees operator new, while the QSet
+// dedup tables of Steps 2-3 allocate with malloc; so a thread samples the resident set and,
+// once it passes the limit, cancels the steps, which stop at their next outer iteration.
+class ResidentLimit {
+public:
+    ResidentLimit(size_t limitBytes, int intervalMs = 20)
+        : m_limit(limitBytes), m_interval(intervalMs), m_stopping(false), m_exceededBytes(0), m_stage("") {
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    ~ResidentLimit() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    const CancellationToken* token() const { return &m_token; }
+    bool exceeded() const { return m_exceededBytes.load() != 0; }
+    size_t exceededBytes() const { return m_exceededBytes.load(); }
+    const char* stage() const { return m_stage.load(); }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_wake.wait_for(lock, m_interval, [this]() { return m_stopping; })) {
+            size_t resident = residentBytes();
+            if (resident > m_limit) {
+                m_stage.store(currentMemoryStage());
+                m_exceededBytes.store(resident);
+                m_token.cancel();
+                return;
+            }
+        }
+    }
+
+    size_t m_limit;
+    std::chrono::milliseconds m_interval;
+    CancellationToken m_token;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopping;
+    std::atomic<size_t> m_exceededBytes;
+    std::atomic<const char*> m_stage;
+    std::thread m_thread;
+};
+
+// hexrecon sweep: evaluates Steps 2-3 for every combination of tolerances, running Step 1 once.
+int runSweep(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Reports face and hexahedron counts for a grid of Step 2 tolerances.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("points", "Point file: text with one \"x y z required_neighbors\" record per line, or binary .hxp.");
+    QCommandLineOption coplanarityOption("coplanarity", "Comma-separated coplanarity tolerances.", "list", "0.001");
+    QCommandLineOption diagonalOption("diagonal-ratio", "Comma-separated diagonal/edge ratios.", "list", "1.01");
+    parser.addOption(coplanarityOption);
+    parser.addOption(diagonalOption);
+    parser.process(arguments);
+
+    if (parser.positionalArguments().size() != 1) parser.showHelp(1);
+    std::vector<float> coplanarities, ratios;
+    if (!parseFloatList(parser.value(coplanarityOption), coplanarities) ||
+        !parseFloatList(parser.value(diagonalOption), ratios)) {
+        QTextStream(stderr) << "Tolerance lists must be comma-separated numbers.\n";
+        return 1;
+    }
+
+    std::vector<MeshPoint> points;
+    if (!loadPointsOrReport(parser.positionalArguments().first(), points)) return 1;
+
+    std::vector<FaceTolerances> settings;
+    for (float coplanarity : coplanarities) {
+        for (float ratio : ratios) settings.push_back(FaceTolerances(coplanarity, ratio));
+    }
+
+    ToleranceSweep sweep(points);
+    QTextStream out(stdout);
+    out << "# " << points.size() << " points, " << sweep.candidateCount() << " candidate 4-cycles\n";
+    out << "coplanarity\tdiagonal_ratio\tfaces\thexahedra\n";
+    for (const SweepResult& result : sweep.evaluate(settings)) {
+        out << result.tolerances.coplanarity << '\t' << result.tolerances.diagonalRatio << '\t'
+            << result.faces << '\t' << result.hexahedra << '\n';
+    }
+    return 0;
+}
+
+// hexrecon run: reconstructs one file stage by stage, reporting time and memory per stage.
+int runStages(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Reconstructs one point file and reports the time, allocations and peak memory of each stage.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("points", "Point file: text, or binary .hxp.");
+    parser.addPositionalArgument("mesh", "Optional output mesh (.vtk, or binary .hxm).", "[mesh]");
+    QCommandLineOption limitOption("memory-limit", "Abort once live allocations would exceed this many MB, or once the resident "
+                                   "set (which also holds Qt containers) does; the latter is checked between iterations of Steps 1-3.", "mb");
+    QCommandLineOption perfOption("perf", "Also report hardware counters per stage: IPC, and LLC and branch misses per candidate (Linux).");
+    QCommandLineOption timeLimitOption("time-limit", "Stop Steps 1-3 after this many seconds in total and keep the partial results.", "seconds");
+    QCommandLineOption progressOption("progress", "Print the progress of Steps 1-3 to stderr every this many seconds.", "seconds");
+    parser.addOptions({limitOption, perfOption, timeLimitOption, progressOption});
+    parser.process(arguments);
+
+    const QStringList paths = parser.positionalArguments();
+    if (paths.isEmpty() || paths.size() > 2) parser.showHelp(1);
+    if (parser.isSet(limitOption)) {
+        bool ok = false;
+        int limitMb = parser.value(limitOption).toInt(&ok);
+        if (!ok || limitMb <= 0) {
+            QTextStream(stderr) << "The memory limit must be a positive number of MB.\n";
+            return 1;
+        }
+        setMemoryCeiling((size_t)limitMb << 20);
+    }
+    const size_t residentLimitBytes = parser.isSet(limitOption) ? memoryCeiling() : 0;
+    double timeLimit = 0.0;
+    if (parser.isSet(timeLimitOption)) {
+        bool ok = false;
+        timeLimit = parser.value(timeLimitOption).toDouble(&ok);
+        if (!ok || timeLimit <= 0.0) {
+            QTextStream(stderr) << "The time limit must be a positive number of seconds.\n";
+            return 1;
+        }
+    }
+    int progressMs = 0;
+    if (parser.isSet(progressOption)) {
+        bool ok = false;
+        progressMs = (int)(1000.0 * parser.value(progressOption).toDouble(&ok));
+        if (!ok || progressMs <= 0) {
+            QTextStream(stderr) << "The progress interval must be a positive number of seconds.\n";
+            return 1;
+        }
+    }
+
+    // Opened before any stage runs, so that the engine's worker threads are counted too.
+    std::unique_ptr<PerfCounters> counters;
+    if (parser.isSet(perfOption)) {
+        counters.reset(new PerfCounters());
+        if (!counters->isAvailable()) {
+            QTextStream(stderr) << "Hardware counters unavailable: " << counters->errorString() << '\n';
+            counters.reset();
+        }
+    }
+
+    struct StageCounters {
+        const char* stage;
+        uint64_t candidates;
+        PerfReading reading;
+    };
+    std::vector<StageCounters> perfRows;
+
+    typedef std::chrono::steady_clock Clock;
+    auto megabytes = [](size_t bytes) { return bytes / 1048576.0; };
+    QTextStream out(stdout);
+    out << "stage\tms\tkept_MB\tpeak_MB\tallocations\tfrees\trss_peak_MB\n";
+
+    // Runs one stage under a MemoryScope (and the counters), then prints its row. `candidates`
+    // is the stage's number of work items, used to normalize the counter values.
+    auto runStage = [&](const char* name, const std::function<bool()>& body, const std::function<uint64_t()>& candidates) {
+        MemoryScope scope(name);
+        Clock::time_point start = Clock::now();
+        if (counters) counters->start();
+        if (!body()) return false;
+        PerfReading reading = counters ? counters->stop() : PerfReading();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        StageMemory stage = scope.finish();
+        out << stage.stage << '\t' << ms << '\t' << megabytes(stage.endBytes) - megabytes(stage.startBytes) << '\t'
+            << megabytes(stage.peakBytes) << '\t' << stage.allocations << '\t' << stage.frees << '\t'
+            << megabytes(stage.residentPeakBytes) << '\n';
+        out.flush();
+        if (counters) perfRows.push_back({name, candidates ? candidates() : 0, reading});
+        return true;
+    };
+
+    std::vector<MeshPoint> points;
+    AdjacencyGraph adjGraph;
+    std::vector<QuadFace> faces;
+    std::vector<Hexahedron> hexahedra;
+    // The budget starts once the points are loaded; a stopped step skips the ones after it.
+    StopCondition stop;
+    StepStatus status = StepStatus::Completed;
+    const char* stoppedStep = nullptr;
+    auto stopped = [&](const char* step) {
+        if (status != StepStatus::Completed && !stoppedStep) stoppedStep = step;
+        return status != StepStatus::Completed;
+    };
+    // Sampled by a monitor thread, so the steps only bump a counter per outer iteration.
+    ProgressCounter progressCounter;
+    ProgressCounter* progress = progressMs > 0 ? &progressCounter : nullptr;
+    std::unique_ptr<ProgressMonitor> monitor;
+    std::unique_ptr<ResidentLimit> residentLimit;
+    try {
+        bool ok = runStage("load", [&]() { return loadPointsOrReport(paths[0], points); }, nullptr);
+        if (ok && residentLimitBytes) residentLimit.reset(new ResidentLimit(residentLimitBytes));
+        const CancellationToken* memoryToken = residentLimit ? residentLimit->token() : nullptr;
+        if (ok) stop = timeLimit > 0.0 ? StopCondition::after(timeLimit, memoryToken) : StopCondition(memoryToken);
+        if (ok && progress) monitor.reset(new ProgressMonitor(progressCounter, printProgress, progressMs));
+        ok = ok &&
+            runStage("step1", [&]() {
+                adjGraph = buildAdjacencyGraph(points, stop, &status, progress);
+                return true;
+            }, [&]() { return adjacencyCandidateCount(points.size()); }) &&
+            (stopped("step1") || runStage("step2", [&]() {
+                faces = findValidFaces(points, adjGraph, FaceTolerances(), stop, &status, progress);
+                return true;
+            }, [&]() { return faceCandidateCount(adjGraph, (int)points.size()); })) &&
+            (stopped("step2") || runStage("step3", [&]() {
+                hexahedra = buildHexahedra(faces, adjGraph, stop, &status, progress);
+                return true;
+            }, [&]() { return facePairCount(faces.size()); }));
+        stopped("step3");
+        monitor.reset();
+        if (residentLimit && residentLimit->exceeded()) {
+            setMemoryCeiling(0);
+            QTextStream(stderr) << "Aborted: resident memory of " << residentLimit->exceededBytes() / 1048576 << " MB exceeds the "
+                                << residentLimitBytes / 1048576 << " MB limit in stage '" << residentLimit->stage() << "'\n";
+            return 3;
+        }
+        residentLimit.reset();
+        if (ok && paths.size() == 2) {
+            ok = runStage("save", [&]() {
+                QString error;
+                if (saveHexMeshFile(paths[1], points, hexahedra, &error)) return true;
+                QTextStream(stderr) << error << '\n';
+                return false;
+            }, nullptr);
+        }
+        if (!ok) return 1;
+    } catch (const MemoryCeilingExceeded& error) {
+        // Lift the ceiling so that reporting can allocate.
+        setMemoryCeiling(0);
+        QTextStream(stderr) << "Aborted: " << error.what() << '\n';
+        return 3;
+    }
+
+    MemoryCounters total = memoryCounters();
+    out << "# " << points.size() << " points, " << faces.size() << " faces, " << hexahedra.size() << " hexahedra; peak "
+        << megabytes(total.peakBytes) << " MB live, " << total.allocations << " allocations\n";
+    if (stoppedStep) out << "# " << stoppedStep << " " << stepStatusName(status) << "; results are partial\n";
+
+    if (!perfRows.empty()) {
+        // Unavailable events print as -.
+        auto value = [](const PerfReading& reading, PerfEvent event) {
+            return reading.valid[event] ? QString::number(reading.values[event]) : QString("-");
+        };
+        auto perCandidate = [](const PerfReading& reading, PerfEvent event, uint64_t candidates) {
+            return reading.valid[event] && candidates ? QString::number((double)reading.values[event] / candidates, 'g', 4) : QString("-");
+        };
+        out << "\nstage\tcycles\tinstructions\tipc\tllc_misses\tbranch_misses\tcandidates\tllc_per_candidate\tbranch_misses_per_candidate\n";
+        for (const StageCounters& row : perfRows) {
+            out << row.stage << '\t' << value(row.reading, PerfCycles) << '\t' << value(row.reading, PerfInstructions) << '\t'
+                << QString::number(row.reading.ipc(), 'f', 2) << '\t' << value(row.reading, PerfCacheMisses) << '\t'
+                << value(row.reading, PerfBranchMisses) << '\t' << row.candidates << '\t'
+                << perCandidate(row.reading, PerfCacheMisses, row.candidates) << '\t'
+                << perCandidate(row.reading, PerfBranchMisses, row.candidates) << '\n';
+        }
+    }
+    return stoppedStep ? 4 : 0;
+}
+
+// hexrecon batch: reconstructs many point files, overlapping file I/O with reconstruction.
+int runBatchCommand(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Reconstructs point files (text, or binary .hxp) and writes each mesh as <name>.vtk or <name>.hxm.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("points", "Point files to reconstruct.", "points...");
+    QCommandLineOption outDirOption("out-dir", "Directory for the mesh files (default: next to each input).", "dir");
+    QCommandLineOption readersOption("readers", "Threads loading point files.", "n", "1");
+    QCommandLineOption workersOption("workers", "Threads reconstructing meshes.", "n", "1");
+    QCommandLineOption writersOption("writers", "Threads writing meshes.", "n", "1");
+    QCommandLineOption depthOption("queue-depth", "Jobs buffered between stages.", "n", "2");
+    QCommandLineOption formatOption("format", "Mesh format: vtk (legacy ASCII VTK) or hxm (binary).", "format", "vtk");
+    QCommandLineOption asyncOption("async-io", "Read .hxp and write .hxm files with the asynchronous bulk I/O backend.");
+    parser.addOptions({outDirOption, readersOption, workersOption, writersOption, depthOption, formatOption, asyncOption});
+    parser.process(arguments);
+
+    const QStringList inputs = parser.positionalArguments();
+    if (inputs.isEmpty()) parser.showHelp(1);
+
+    BatchOptions options;
+    bool ok[4];
+    options.readers = parser.value(readersOption).toInt(&ok[0]);
+    options.workers = parser.value(workersOption).toInt(&ok[1]);
+    options.writers = parser.value(writersOption).toInt(&ok[2]);
+    options.queueDepth = parser.value(depthOption).toInt(&ok[3]);
+    if (!ok[0] || !ok[1] || !ok[2] || !ok[3]) {
+        QTextStream(stderr) << "Thread counts and queue depth must be integers.\n";
+        return 1;
+    }
+    QString format = parser.value(formatOption);
+    if (format != "vtk" && format != "hxm") {
+        QTextStream(stderr) << "Unknown mesh format " << format << ".\n";
+        return 1;
+    }
+    if (parser.isSet(asyncOption)) options.io = IoBackend::Async;
+
+    std::vector<BatchJob> jobs;
+    for (const QString& input : inputs) {
+        QFileInfo info(input);
+        QDir dir = parser.isSet(outDirOption) ? QDir(parser.value(outDirOption)) : info.dir();
+        jobs.push_back({input, dir.filePath(info.completeBaseName() + '.' + format)});
+    }
+
+    QTextStream out(stdout);
+    out << "file\tpoints\thexahedra\tread_ms\treconstruct_ms\twrite_ms\n";
+    std::vector<BatchJobResult> results = runBatch(jobs, options, [&](int job, const BatchJobResult& result) {
+        if (!result.ok) {
+            QTextStream(stderr) << result.error << '\n';
+            return;
+        }
+        out << jobs[job].inputPath << '\t' << result.points << '\t' << result.hexahedra << '\t' << result.readMs << '\t'
+            << result.reconstructMs << '\t' << result.writeMs << '\n';
+        out.flush();
+    });
+
+    int failed = 0;
+    for (const BatchJobResult& result : results) {
+        if (!result.ok) ++failed;
+    }
+    out << "# " << (jobs.size() - failed) << " of " << jobs.size() << " files reconstructed\n";
+    return failed ? 1 : 0;
+}
+
+// hexrecon iobench: compares the synchronous and asynchronous bulk I/O backends.
+int runIoBenchmark(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Writes and reads back a scratch file with each bulk I/O backend and reports MB/s.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("scratch", "Path of the scratch file (removed afterwards); place it on the disk to measure.");
+    QCommandLineOption sizeOption("size-mb", "Scratch file size in MB.", "mb", "256");
+    QCommandLineOption repeatOption("repeat", "Repetitions per backend; the best is reported.", "n", "3");
+    parser.addOptions({sizeOption, repeatOption});
+    parser.process(arguments);
+
+    if (parser.positionalArguments().size() != 1) parser.showHelp(1);
+    bool sizeOk = false, repeatOk = false;
+    int sizeMb = parser.value(sizeOption).toInt(&sizeOk);
+    int repetitions = parser.value(repeatOption).toInt(&repeatOk);
+    if (!sizeOk || !repeatOk || sizeMb <= 0 || repetitions <= 0) {
+        QTextStream(stderr) << "Size and repetitions must be positive integers.\n";
+        return 1;
+    }
+
+    std::vector<IoBenchmarkResult> results;
+    QString error;
+    if (!benchmarkBulkIo(parser.positionalArguments().first(), (size_t)sizeMb << 20, repetitions, results, &error)) {
+        QTextStream(stderr) << error << '\n';
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    out << "# async backend: " << (ioUringAvailable() ? "io_uring" : "pread/pwrite") << '\n';
+    out << "backend\twrite_MBps\tread_MBps\n";
+    for (const IoBenchmarkResult& result : results) {
+        out << (result.backend == IoBackend::Async ? "async" : "synchronous") << '\t' << result.writeMBps << '\t' << result.readMBps << '\n';
+    }
+    return 0;
+}
+
+// hexrecon hashbench: insert throughput of the shared dedup set under contention.
+int runHashBenchmark(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compares the lock-free dedup set with a mutex-guarded QSet at several thread counts.");
+    parser.addHelpOption();
+    QCommandLineOption keysOption("keys", "Distinct 8-int keys, each inserted three times.", "n", "1000000");
+    QCommandLineOption threadsOption("threads", "Comma-separated thread counts.", "list", "1,2,4,8,16,32,64");
+    parser.addOptions({keysOption, threadsOption});
+    parser.process(arguments);
+
+    bool ok = false;
+    int keyCount = parser.value(keysOption).toInt(&ok);
+    std::vector<float> counts;
+    if (!ok || keyCount <= 0 || !parseFloatList(parser.value(threadsOption), counts)) {
+        QTextStream(stderr) << "Key count and thread counts must be positive numbers.\n";
+        return 1;
+    }
+    std::vector<int> threadCounts;
+    for (float count : counts) threadCounts.push_back((int)count);
+
+    QTextStream out(stdout);
+    out << "threads\tlock_free_Mops\tmutex_qset_Mops\n";
+    for (const KeySetContention& result : benchmarkKeySetContention(keyCount, threadCounts)) {
+        out << result.threads << '\t' << result.lockFreeMops << '\t' << result.mutexMops << '\n';
+    }
+    return 0;
+}
+
+int runScalingBenchmarkCommand(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times Steps 1-3 on generated grids across thread counts and reports parallel efficiency per step.");
+    parser.addHelpOption();
+    QCommandLineOption threadsOption("threads", "Comma-separated thread counts; the first is the baseline.", "list", "1,2,4,8,16,32,64");
+    QCommandLineOption gridOption("grid", "Lattice points per axis (weak scaling stretches x with the thread count).", "n", "10");
+    QCommandLineOption modeOption("mode", "strong, weak or both.", "mode", "both");
+    QCommandLineOption repeatOption("repeat", "Repetitions per measurement; the fastest is reported.", "n", "1");
+    QCommandLineOption thresholdOption("threshold", "Flag steps whose parallel efficiency is below this.", "value", "0.7");
+    QCommandLineOption csvOption("csv", "Also write the samples as CSV to this file.", "path");
+    parser.addOptions({threadsOption, gridOption, modeOption, repeatOption, thresholdOption, csvOption});
+    parser.process(arguments);
+
+    ScalingOptions options;
+    bool gridOk = false, repeatOk = false, thresholdOk = false;
+    options.gridSize = parser.value(gridOption).toInt(&gridOk);
+    options.repetitions = parser.value(repeatOption).toInt(&repeatOk);
+    options.threshold = parser.value(thresholdOption).toDouble(&thresholdOk);
+    std::vector<float> counts;
+    if (!gridOk || options.gridSize < 2 || !repeatOk || options.repetitions <= 0 || !thresholdOk ||
+        !parseFloatList(parser.value(threadsOption), counts)) {
+        QTextStream(stderr) << "Grid size, repetitions, threshold and thread counts must be positive numbers.\n";
+        return 1;
+    }
+    options.threadCounts.clear();
+    for (float count : counts) options.threadCounts.push_back(std::max(1, (int)count));
+    QString mode = parser.value(modeOption);
+    if (mode != "strong" && mode != "weak" && mode != "both") {
+        QTextStream(stderr) << "Unknown mode '" << mode << "'; use strong, weak or both.\n";
+        return 1;
+    }
+    options.strong = mode != "weak";
+    options.weak = mode != "strong";
+
+    std::vector<ScalingSample> samples = runScalingBenchmark(options);
+    QTextStream(stdout) << formatScalingTable(samples);
+
+    if (parser.isSet(csvOption)) {
+        QFile csv(parser.value(csvOption));
+        if (!csv.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            QTextStream(stderr) << "Cannot write " << csv.fileName() << '\n';
+            return 1;
+        }
+        QTextStream(&csv) << formatScalingCsv(samples);
+    }
+    return 0;
+}
+
+// hexrecon verify: compares every optimized path and derived feature with the reference engine.
+int runVerify(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Checks the optimized Steps 1-3, layer streaming, extrusion, regions, frame series and tolerance sweeps against the reference engine on generated inputs and on the given point files.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("points", "Optional point files to check as well.", "[points...]");
+    QCommandLineOption casesOption("cases", "Random cases per generator (grids, perturbed grids, noisy clouds).", "n", "40");
+    QCommandLineOption seedOption("seed", "Seed of the random cases.", "n", "1");
+    QCommandLineOption threadsOption("threads", "Comma-separated thread counts to run the parallel paths at.", "list", "1,4");
+    parser.addOptions({casesOption, seedOption, threadsOption});
+    parser.process(arguments);
+
+    DifferentialOptions options;
+    bool casesOk = false, seedOk = false;
+    options.randomCases = parser.value(casesOption).toInt(&casesOk);
+    options.seed = parser.value(seedOption).toUInt(&seedOk);
+    std::vector<float> counts;
+    if (!casesOk || options.randomCases < 0 || !seedOk || !parseFloatList(parser.value(threadsOption), counts)) {
+        QTextStream(stderr) << "Case count, seed and thread counts must be non-negative numbers.\n";
+        return 1;
+    }
+    options.threadCounts.clear();
+    for (float count : counts) options.threadCounts.push_back(std::max(1, (int)count));
+
+    std::vector<DifferentialCase> cases = generateDifferentialCases(options);
+    for (const QString& path : parser.positionalArguments()) {
+        DifferentialCase file;
+        file.name = path;
+        if (!loadPointsOrReport(path, file.points)) return 1;
+        cases.push_back(file);
+    }
+
+    DifferentialReport report = runDifferentialChecks(cases, optimizedPaths(), options.threadCounts, differentialFeatures());
+    QTextStream out(stdout);
+    for (const DifferentialMismatch& mismatch : report.mismatches) {
+        out << "MISMATCH " << mismatch.path << ' ' << mismatch.stage << " (" << mismatch.threads << " threads) on "
+            << mismatch.caseName << ": " << mismatch.detail << '\n';
+    }
+    out << report.cases << " cases, " << report.comparisons << " comparisons, " << report.mismatches.size() << " mismatches\n";
+    return report.mismatches.empty() ? 0 : 1;
+}
+
+// hexrecon preview: reconstructs sample patches and estimates the size of the full result.
+int runPreview(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Reconstructs small patches spread over a point file and estimates the full hexahedron count.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("points", "Point file: text with one \"x y z required_neighbors\" record per line, or binary .hxp.");
+    QCommandLineOption patchesOption("patches", "Patches per axis.", "n", "2");
+    QCommandLineOption sizeOption("patch-size", "Edge length of a patch, in point spacings.", "spacings", "3");
+    QCommandLineOption haloOption("halo", "Context margin around a patch, in point spacings.", "spacings", "1.5");
+    parser.addOptions({patchesOption, sizeOption, haloOption});
+    parser.process(arguments);
+
+    if (parser.positionalArguments().size() != 1) parser.showHelp(1);
+    PreviewOptions options;
+    bool patchesOk = false, sizeOk = false, haloOk = false;
+    options.patchesPerAxis = parser.value(patchesOption).toInt(&patchesOk);
+    options.patchSpacings = parser.value(sizeOption).toFloat(&sizeOk);
+    options.haloSpacings = parser.value(haloOption).toFloat(&haloOk);
+    if (!patchesOk || options.patchesPerAxis < 1 || !sizeOk || options.patchSpacings <= 0.0f || !haloOk || options.haloSpacings < 0.0f) {
+        QTextStream(stderr) << "Patch count and size must be positive numbers and the halo non-negative.\n";
+        return 1;
+    }
+
+    std::vector<MeshPoint> points;
+    if (!loadPointsOrReport(parser.positionalArguments().first(), points)) return 1;
+
+    PreviewResult preview = reconstructPreview(points, options);
+    QTextStream out(stdout);
+    out << points.size() << " points, " << preview.patches << " patches, " << preview.reconstructedPoints << " points reconstructed in "
+        << QString::number(preview.seconds * 1000.0, 'f', 1) << " ms\n";
+    out << preview.faces.size() << " faces and " << preview.hexahedra.size() << " hexahedra in the patches; about "
+        << QString::number(preview.estimatedHexahedra, 'f', 0) << " hexahedra expected in total\n";
+    return 0;
+}
+
+// hexrecon region: reconstructs only the cells inside a box or sphere.
+int runRegion(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Reconstructs the hexahedra whose centroid lies inside a box or sphere, using only the points nearby.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("points", "Point file: text, or binary .hxp.");
+    parser.addPositionalArgument("mesh", "Optional output mesh (.vtk, or binary .hxm) with the points near the region.", "[mesh]");
+    QCommandLineOption boxOption("box", "Box as minimum and maximum corner.", "x0,y0,z0,x1,y1,z1");
+    QCommandLineOption sphereOption("sphere", "Sphere as center and radius.", "x,y,z,r");
+    QCommandLineOption haloOption("halo", "Context margin around the region, in point spacings.", "spacings", QString::number(kDefaultHaloSpacings));
+    parser.addOptions({boxOption, sphereOption, haloOption});
+    parser.process(arguments);
+
+    const QStringList paths = parser.positionalArguments();
+    if (paths.isEmpty() || paths.size() > 2 || parser.isSet(boxOption) == parser.isSet(sphereOption)) parser.showHelp(1);
+    std::vector<float> values;
+    RegionOfInterest roi;
+    if (parser.isSet(boxOption) && parseFloatList(parser.value(boxOption), values) && values.size() == 6) {
+        roi = RegionOfInterest::box(Vector3(values[0], values[1], values[2]), Vector3(values[3], values[4], values[5]));
+    } else if (parser.isSet(sphereOption) && parseFloatList(parser.value(sphereOption), values) && values.size() == 4 && values[3] >= 0.0f) {
+        roi = RegionOfInterest::sphere(Vector3(values[0], values[1], values[2]), values[3]);
+    } else {
+        QTextStream(stderr) << "--box takes six numbers and --sphere four, with a non-negative radius.\n";
+        return 1;
+    }
+    bool haloOk = false;
+    float haloSpacings = parser.value(haloOption).toFloat(&haloOk);
+    if (!haloOk || haloSpacings < 0.0f) {
+        QTextStream(stderr) << "The halo must be a non-negative number of point spacings.\n";
+        return 1;
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    auto msSince = [](Clock::time_point start) { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); };
+    QTextStream out(stdout);
+    std::vector<MeshPoint> points;
+    Clock::time_point start = Clock::now();
+    if (!loadPointsOrReport(paths[0], points)) return 1;
+    out << "load\t" << msSince(start) << " ms\t" << points.size() << " points\n";
+
+    start = Clock::now();
+    UniformGridIndex index(points);
+    out << "index\t" << msSince(start) << " ms\n";
+
+    start = Clock::now();
+    RegionResult region = reconstructRegion(points, index, roi, haloSpacings * index.cellSize());
+    out << "region\t" << msSince(start) << " ms\t" << region.corePoints << " points inside, " << region.pointIndices.size()
+        << " with the halo; " << region.faces.size() << " faces, " << region.hexahedra.size() << " hexahedra\n";
+
+    if (paths.size() == 2) {
+        // Only the points near the region go into the mesh.
+        std::vector<MeshPoint> subset;
+        std::unordered_map<int, int> local;
+        for (int i : region.pointIndices) {
+            local[i] = (int)subset.size();
+            subset.push_back(points[i]);
+        }
+        std::vector<Hexahedron> cells = region.hexahedra;
+        for (Hexahedron& cell : cells) {
+            for (int& v : cell) v = local[v];
+        }
+        QString error;
+        if (!saveHexMeshFile(paths[1], subset, cells, &error)) {
+            QTextStream(stderr) << error << '\n';
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void printUsage() {
+    QTextStream(stderr) << "Usage: hexrecon <command> [options]\n"
+                           "\n"
+                           "Commands:\n"
+                           "  batch      Reconstruct many point files and write their meshes\n"
+                           "  hashbench  Compare the lock-free dedup set with a locked QSet under contention\n"
+                           "  iobench    Compare the synchronous and asynchronous file I/O backends\n"
+                           "  preview    Reconstruct sample patches and estimate the full result\n"
+                           "  region     Reconstruct only the cells inside a box or sphere\n"
+                           "  run        Reconstruct one file and report time and memory per stage\n"
+                           "  scaling    Measure strong and weak scaling of Steps 1-3 on generated grids\n"
+                           "  sweep      Count faces and hexahedra for many tolerance settings\n"
+                           "  verify     Check the optimized paths and features against the reference engine\n"
+                           "\n"
+                           "Run 'hexrecon <command> --help' for the options of a command.\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("hexrecon");
+
+    QStringList arguments = app.arguments();
+    if (arguments.size() < 2) {
+        printUsage();
+        return 1;
+    }
+    QString command = arguments.takeAt(1);
+    if (command == "batch") return runBatchCommand(arguments);
+    if (command == "hashbench") return runHashBenchmark(arguments);
+    if (command == "iobench") return runIoBenchmark(arguments);
+    if (command == "preview") return runPreview(arguments);
+    if (command == "region") return runRegion(arguments);
+    if (command == "run") return runStages(arguments);
+    if (command == "scaling") return runScalingBenchmarkCommand(arguments);
+    if (command == "sweep") return runSweep(arguments);
+    if (command == "verify") return runVerify(arguments);
+
+    printUsage();
+    return 1;
+}
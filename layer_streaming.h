@@ -0,0 +1,175 @@
+#ifndef LAYER_STREAMING_H
+#define LAYER_STREAMING_H
+
+#include <exception>
+#include <functional>
+#include <thread>
+#include "reconstruction_engine.h"
+#include "bounded_queue.h"
+
+namespace ReconstructionEngine {
+    // Pulls the next z-layer of the input into `layer`; returns false once the input is exhausted.
+    using LayerSource = std::function<bool(std::vector<MeshPoint>& layer)>;
+
+    // Receives the hexahedra of one slab, indexed into the concatenation of all layers read so far.
+    using HexahedronSink = std::function<void(const std::vector<Hexahedron>& hexahedra)>;
+
+    /**
+     * @struct LayerStreamSummary
+     * @brief Totals reported by a completed streaming reconstruction.
+     */
+    struct LayerStreamSummary {
+        int layers = 0;
+        int points = 0;
+        int hexahedra = 0;
+    };
+
+    /**
+     * @brief Number of neighbors a layer point has inside its own layer.
+     *
+     * In an extruded block every point is linked to exactly one point in each adjacent layer,
+     * so those links are subtracted from the point's full neighbor constraint.
+     */
+    inline int inLayerNeighborBudget(const MeshPoint& point, bool hasLayerBelow, bool hasLayerAbove) {
+        int budget = point.required_neighbors - (hasLayerBelow ? 1 : 0) - (hasLayerAbove ? 1 : 0);
+        return std::max(budget, 0);
+    }
+
+    /**
+     * @brief Reconstructs the hexahedra between two consecutive layers.
+     *
+     * Only the two layers are considered. The neighbor constraints are reduced by the links
+     * leading outside the slab, so Steps 1-3 see a self-contained one-cell-thick block.
+     * Returned indices are offset by `lowerOffset`, the stream position of the lower layer.
+     */
+    inline std::vector<Hexahedron> reconstructSlab(const std::vector<MeshPoint>& lower, const std::vector<MeshPoint>& upper,
+                                                   bool hasLayerBelow, bool hasLayerAbove, int lowerOffset = 0) {
+        std::vector<MeshPoint> slab;
+        slab.reserve(lower.size() + upper.size());
+        for (const MeshPoint& p : lower) {
+            slab.push_back({p.pos, inLayerNeighborBudget(p, hasLayerBelow, false) });
+        }
+        for (const MeshPoint& p : upper) {
+            slab.push_back({p.pos, inLayerNeighborBudget(p, false, hasLayerAbove) });
+        }
+
+        AdjacencyGraph slabGraph = buildAdjacencyGraph(slab);
+        std::vector<QuadFace> slabFaces = findValidFaces(slab, slabGraph);
+        std::vector<Hexahedron> hexahedra = buildHexahedra(slabFaces, slabGraph);
+        for (Hexahedron& hex : hexahedra) {
+            for (int& idx : hex) idx += lowerOffset;
+        }
+        return hexahedra;
+    }
+
+    /**
+     * @brief Streaming reconstruction of layered inputs with constant memory.
+     *
+     * A reader thread pulls layers from `source` and a writer thread hands finished slabs to
+     * `sink`, while the calling thread reconstructs the slab between layer k and k+1. Besides
+     * the two slab layers only the read-ahead layer (needed to know whether k+1 is the last
+     * layer) and at most `queueDepth` queued layers and slabs are held in memory.
+     *
+     * If `source`, `sink` or a slab throws, the pipeline winds down, both threads are joined
+     * and the first exception (calling thread, then reader, then writer) is rethrown.
+     */
+    inline LayerStreamSummary reconstructLayerStream(const LayerSource& source, const HexahedronSink& sink, int queueDepth = 2) {
+        LayerStreamSummary summary;
+        BoundedQueue<std::vector<MeshPoint>> layerQueue(queueDepth);
+        BoundedQueue<std::vector<Hexahedron>> slabQueue(queueDepth);
+
+        std::exception_ptr readerError, writerError, error;
+        std::thread reader([&]() {
+            try {
+                std::vector<MeshPoint> layer;
+                while (source(layer)) {
+                    if (!layerQueue.push(std::move(layer))) break;
+                    layer = std::vector<MeshPoint>();
+                }
+            } catch (...) {
+                readerError = std::current_exception();
+            }
+            layerQueue.close();
+        });
+        std::thread writer([&]() {
+            try {
+                std::vector<Hexahedron> slabHexahedra;
+                while (slabQueue.pop(slabHexahedra)) sink(slabHexahedra);
+            } catch (...) {
+                writerError = std::current_exception();
+            }
+            // Makes further pushes fail, so the calling thread stops instead of blocking.
+            slabQueue.close();
+        });
+
+        try {
+            std::vector<MeshPoint> lower, upper, next;
+            bool hasUpper = layerQueue.pop(lower) && layerQueue.pop(upper);
+            if (!lower.empty() || hasUpper) {
+                summary.layers = hasUpper ? 2 : 1;
+                summary.points = (int)(lower.size() + upper.size());
+            }
+
+            int lowerOffset = 0;
+            bool hasLayerBelow = false;
+            while (hasUpper) {
+                bool hasNext = layerQueue.pop(next);
+                std::vector<Hexahedron> slabHexahedra = reconstructSlab(lower, upper, hasLayerBelow, hasNext, lowerOffset);
+                summary.hexahedra += (int)slabHexahedra.size();
+                if (!slabQueue.push(std::move(slabHexahedra))) break;
+
+                lowerOffset += (int)lower.size();
+                hasLayerBelow = true;
+                lower.swap(upper);
+                upper.swap(next);
+                next.clear();
+                hasUpper = hasNext;
+                if (hasNext) {
+                    ++summary.layers;
+                    summary.points += (int)upper.size();
+                }
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        // Closing unblocks the reader's push; the writer drains what is queued and stops.
+        slabQueue.close();
+        layerQueue.close();
+        reader.join();
+        writer.join();
+        if (!error) error = readerError ? readerError : writerError;
+        if (error) std::rethrow_exception(error);
+        return summary;
+    }
+
+    /**
+     * @brief Groups a flat point list into z-layers, ordered bottom to top.
+     *
+     * Points whose z differs from the first point of the current layer by less than
+     * `tolerance` share that layer. If `streamToInput` is given, it receives the original
+     * index of every point in the concatenated layer order.
+     */
+    inline std::vector<std::vector<MeshPoint>> splitIntoLayers(const std::vector<MeshPoint>& points, float tolerance = 1e-3f,
+                                                               std::vector<int>* streamToInput = nullptr) {
+        std::vector<int> order(points.size());
+        for (size_t i = 0; i < points.size(); ++i) order[i] = (int)i;
+        std::stable_sort(order.begin(), order.end(), [&points](int a, int b) {
+            return points[a].pos.z() < points[b].pos.z();
+        });
+
+        std::vector<std::vector<MeshPoint>> layers;
+        float layerZ = 0.0f;
+        for (int idx : order) {
+            if (layers.empty() || std::abs(points[idx].pos.z() - layerZ) >= tolerance) {
+                layers.emplace_back();
+                layerZ = points[idx].pos.z();
+            }
+            layers.back().push_back(points[idx]);
+        }
+        if (streamToInput) *streamToInput = order;
+        return layers;
+    }
+} // namespace ReconstructionEngine
+
+#endif // LAYER_STREAMING_H
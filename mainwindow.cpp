@@ -1,11 +1,46 @@
 #include "mainwindow.h"
 #include "glwidget.h"
+#include "performance_panel.h"
+#include "perf_counters.h"
+#include "pipelined_reconstruction.h"
+#include "point_file_loader.h"
+#include "preview_reconstruction.h"
+#include <QAction>
+#include <QCheckBox>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMenuBar>
+#include <QMessageBox>
+#include <QProgressBar>
 #include <QPushButton>
+#include <QStatusBar>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QWidget>
 #include <QDebug>
 
+namespace {
+    // Runs `step` inside a MemoryScope and fills the timing and memory figures of `stats`.
+    template <typename Fn>
+    void measureStep(const char *stage, StepStatistics &stats, Fn step) {
+        ReconstructionEngine::MemoryScope scope(stage);
+        QElapsedTimer timer;
+        timer.start();
+        step();
+        stats.seconds = timer.nsecsElapsed() / 1e9;
+        stats.memory = scope.finish();
+    }
+
+    void countStep1(StepStatistics &stats, const std::vector<MeshPoint> &points, const AdjacencyGraph &adjGraph) {
+        stats.step = "Step 1";
+        stats.candidates = ReconstructionEngine::adjacencyCandidateCount(points.size());
+        for (const auto &row : adjGraph) stats.results += (qint64)row.second.size();
+        stats.items = (qint64)points.size();
+        stats.itemUnit = "points";
+    }
+}
+
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     setupUI();
 
@@ -25,7 +60,14 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     onReset(); // Set initial state
 }
 
-MainWindow::~MainWindow() {}
+MainWindow::~MainWindow() {
+    // A running Run all writes into m_runAllJob; stop it and let it finish first.
+    if (m_runAllThread.joinable()) {
+        m_runAllJob->cancel.cancel();
+        m_runAllThread.join();
+    }
+    m_loader->cancel();
+}
 
 // Set up the main window layout and connect signals to slots.
 void MainWindow::setupUI() {
@@ -35,12 +77,38 @@ void MainWindow::setupUI() {
     m_step1Button = new QPushButton("Step 1: Build Adjacency Graph", this);
     m_step2Button = new QPushButton("Step 2: Find Faces", this);
     m_step3Button = new QPushButton("Step 3: Build Hexahedra", this);
+    m_runAllButton = new QPushButton("Run All", this);
+    m_runAllButton->setToolTip("Run Steps 1-3 in the background, showing each result as it is ready");
+    m_previewButton = new QPushButton("Preview", this);
+    m_previewButton->setToolTip("Reconstruct a few small patches spread over the points and estimate the full result");
+    m_previewThenRunAll = new QCheckBox("Then run all in the background", this);
 
     // Connect button clicks to their respective handler functions (slots).
     connect(m_resetButton, &QPushButton::clicked, this, &MainWindow::onReset);
     connect(m_step1Button, &QPushButton::clicked, this, &MainWindow::onStep1_BuildGraph);
     connect(m_step2Button, &QPushButton::clicked, this, &MainWindow::onStep2_FindFaces);
     connect(m_step3Button, &QPushButton::clicked, this, &MainWindow::onStep3_BuildHexahedra);
+    connect(m_runAllButton, &QPushButton::clicked, this, &MainWindow::onRunAll);
+    connect(m_previewButton, &QPushButton::clicked, this, &MainWindow::onPreview);
+    connect(this, &MainWindow::runAllProgress, this, &MainWindow::onRunAllProgress, Qt::QueuedConnection);
+    connect(this, &MainWindow::runAllGraphReady, this, &MainWindow::onRunAllGraphReady, Qt::QueuedConnection);
+    connect(this, &MainWindow::runAllFinished, this, &MainWindow::onRunAllFinished, Qt::QueuedConnection);
+
+    // Point files load in the background; the status bar shows progress and a cancel button.
+    // The progress bar also follows Run All.
+    m_loader = new PointFileLoader(this);
+    connect(m_loader, &PointFileLoader::previewReady, this, &MainWindow::onLoadPreviewReady, Qt::QueuedConnection);
+    connect(m_loader, &PointFileLoader::finished, this, &MainWindow::onLoadFinished, Qt::QueuedConnection);
+    m_progressBar = new QProgressBar(this);
+    m_progressBar->setRange(0, 1000);
+    m_progressBar->setMaximumWidth(200);
+    m_progressBar->hide();
+    m_cancelLoadButton = new QPushButton("Cancel", this);
+    m_cancelLoadButton->hide();
+    connect(m_loader, &PointFileLoader::progressChanged, m_progressBar, &QProgressBar::setValue, Qt::QueuedConnection);
+    connect(m_cancelLoadButton, &QPushButton::clicked, m_loader, &PointFileLoader::cancel);
+    statusBar()->addPermanentWidget(m_progressBar);
+    statusBar()->addPermanentWidget(m_cancelLoadButton);
 
     // Set up layouts.
     QVBoxLayout *controlLayout = new QVBoxLayout;
@@ -48,6 +116,11 @@ void MainWindow::setupUI() {
     controlLayout->addWidget(m_step1Button);
     controlLayout->addWidget(m_step2Button);
     controlLayout->addWidget(m_step3Button);
+    controlLayout->addSpacing(12);
+    controlLayout->addWidget(m_runAllButton);
+    controlLayout->addSpacing(12);
+    controlLayout->addWidget(m_previewButton);
+    controlLayout->addWidget(m_previewThenRunAll);
     controlLayout->addStretch();
     QHBoxLayout *mainLayout = new QHBoxLayout;
     mainLayout->addWidget(m_glWidget, 1); // GL widget takes most of the space
@@ -55,6 +128,15 @@ void MainWindow::setupUI() {
     QWidget *centralWidget = new QWidget(this);
     centralWidget->setLayout(mainLayout);
     setCentralWidget(centralWidget);
+
+    // Dockable statistics panel, toggled from the View menu.
+    m_perfPanel = new PerformancePanel(m_glWidget, this);
+    addDockWidget(Qt::BottomDockWidgetArea, m_perfPanel);
+    QMenu *fileMenu = menuBar()->addMenu("&File");
+    m_openAction = fileMenu->addAction("&Open Points...", this, &MainWindow::onOpenPoints, QKeySequence::Open);
+    fileMenu->addSeparator();
+    fileMenu->addAction("&Quit", this, &QWidget::close, QKeySequence::Quit);
+    menuBar()->addMenu("&View")->addAction(m_perfPanel->toggleViewAction());
     resize(1024, 768);
 }
 
@@ -68,19 +150,24 @@ void MainWindow::onReset() {
     // Reset the GL widget and load the initial points.
     m_glWidget->reset();
     m_glWidget->setPoints(m_points);
+    m_perfPanel->clearSteps();
 
     // Reset button states for the step-by-step process.
     m_step1Button->setEnabled(true);
     m_step2Button->setEnabled(false);
     m_step3Button->setEnabled(false);
+    m_runAllButton->setEnabled(true);
     qDebug() << "--- System reset. Points loaded. ---";
 }
 
 // Slot for the Step 1 button.
 void MainWindow::onStep1_BuildGraph() {
     qDebug() << "--- Executing Step 1: Building Adjacency Graph ---";
-    m_adjGraph = ReconstructionEngine::buildAdjacencyGraph(m_points);
+    StepStatistics stats;
+    measureStep("step1", stats, [this]() { m_adjGraph = ReconstructionEngine::buildAdjacencyGraph(m_points); });
     m_glWidget->setAdjacencyGraph(m_adjGraph);
+    countStep1(stats, m_points, m_adjGraph);
+    m_perfPanel->recordStep(stats);
 
     m_step1Button->setEnabled(false);
     m_step2Button->setEnabled(true);
@@ -90,9 +177,16 @@ void MainWindow::onStep1_BuildGraph() {
 // Slot for the Step 2 button.
 void MainWindow::onStep2_FindFaces() {
     qDebug() << "--- Executing Step 2: Finding Faces ---";
-    m_faces = ReconstructionEngine::findValidFaces(m_points, m_adjGraph);
+    StepStatistics stats;
+    measureStep("step2", stats, [this]() { m_faces = ReconstructionEngine::findValidFaces(m_points, m_adjGraph); });
     m_glWidget->setFaces(m_faces);
 
+    stats.step = "Step 2";
+    stats.candidates = ReconstructionEngine::faceCandidateCount(m_adjGraph, (int)m_points.size());
+    stats.results = stats.items = (qint64)m_faces.size();
+    stats.itemUnit = "faces";
+    m_perfPanel->recordStep(stats);
+
     m_step2Button->setEnabled(false);
     m_step3Button->setEnabled(true);
     qDebug() << "Found" << m_faces.size() << "valid faces.";
@@ -101,9 +195,215 @@ void MainWindow::onStep2_FindFaces() {
 // Slot for the Step 3 button.
 void MainWindow::onStep3_BuildHexahedra() {
     qDebug() << "--- Executing Step 3: Building Hexahedra ---";
-    m_hexahedra = ReconstructionEngine::buildHexahedra(m_faces, m_adjGraph);
+    StepStatistics stats;
+    measureStep("step3", stats, [this]() { m_hexahedra = ReconstructionEngine::buildHexahedra(m_faces, m_adjGraph); });
     m_glWidget->setHexahedra(m_hexahedra);
 
+    stats.step = "Step 3";
+    stats.candidates = ReconstructionEngine::facePairCount(m_faces.size());
+    stats.results = stats.items = (qint64)m_hexahedra.size();
+    stats.itemUnit = "hexes";
+    m_perfPanel->recordStep(stats);
+
     m_step3Button->setEnabled(false);
     qDebug() << "Reconstructed" << m_hexahedra.size() << "hexahedra.";
 }
+
+// Slot for the Run All button: runs the whole pipeline on a worker thread. Step 1 uses all
+// cores; Steps 2 and 3 run overlapped (reconstructPipelined), so hexahedra are assembled while
+// faces are still being found. The view shows the graph as soon as Step 1 is done. While it
+// runs, the button cancels it instead, keeping what was found so far.
+void MainWindow::onRunAll() {
+    if (m_runAllThread.joinable()) {
+        m_runAllJob->cancel.cancel();
+        m_runAllButton->setEnabled(false);
+        return;
+    }
+    onReset();
+    startRunAll();
+}
+
+void MainWindow::startRunAll() {
+    setBusy(true);
+    qDebug() << "--- Run All: executing Steps 1-3 in the background ---";
+
+    m_runAllJob.reset(new RunAllJob);
+    m_runAllJob->points = m_points;
+    RunAllJob *job = m_runAllJob.get();
+    m_runAllButton->setText("Cancel Run All");
+    m_runAllButton->setEnabled(true);
+    m_progressBar->setFormat("%p%");
+    m_progressBar->setValue(0);
+    m_progressBar->show();
+    m_runAllThread = std::thread([this, job]() {
+        // Nothing may escape the thread: an exception (e.g. std::bad_alloc on a large input) is
+        // kept in the job, and runAllFinished is still emitted so that the UI thread joins.
+        try {
+            ReconstructionEngine::StopCondition stop(&job->cancel);
+            // The steps only bump counters; the monitor samples them ten times a second. It is
+            // stopped (at the end of this block) before runAllFinished, so that no progress
+            // update arrives after it.
+            ReconstructionEngine::ProgressMonitor monitor(job->progress, [this](const ReconstructionEngine::ProgressSample &sample) {
+                if (sample.stage) emit runAllProgress(QString(sample.stage), (int)(1000.0 * sample.fraction()));
+            });
+            measureStep("step1", job->step1, [job, &stop]() {
+                job->adjGraph = ReconstructionEngine::buildAdjacencyGraphParallel(job->points, stop, &job->status, &job->progress);
+            });
+            countStep1(job->step1, job->points, job->adjGraph);
+            emit runAllGraphReady();
+
+            if (job->status == ReconstructionEngine::StepStatus::Completed) {
+                measureStep("steps2-3", job->steps2and3, [job, &stop]() {
+                    ReconstructionEngine::PipelinedResult result = ReconstructionEngine::reconstructPipelined(
+                        job->points, job->adjGraph, FaceTolerances(), &job->faces, 4096, stop, &job->status, &job->progress);
+                    job->hexahedra = std::move(result.hexahedra);
+                });
+                StepStatistics &stats = job->steps2and3;
+                stats.step = "Steps 2+3";
+                stats.candidates = ReconstructionEngine::faceCandidateCount(job->adjGraph, (int)job->points.size());
+                stats.results = stats.items = (qint64)job->hexahedra.size();
+                stats.itemUnit = "hexes";
+            }
+        } catch (...) {
+            job->error = std::current_exception();
+        }
+        emit runAllFinished();
+    });
+}
+
+void MainWindow::onRunAllProgress(const QString &stage, int permille) {
+    m_progressBar->setFormat(stage + " %p%");
+    m_progressBar->setValue(permille);
+}
+
+// The worker no longer writes the graph; it only reads it from here on.
+void MainWindow::onRunAllGraphReady() {
+    m_glWidget->setAdjacencyGraph(m_runAllJob->adjGraph);
+    m_perfPanel->recordStep(m_runAllJob->step1);
+    qDebug() << "Run All: adjacency graph built.";
+}
+
+void MainWindow::onRunAllFinished() {
+    m_runAllThread.join();
+    std::unique_ptr<RunAllJob> job(std::move(m_runAllJob));
+    m_runAllButton->setText("Run All");
+    m_progressBar->hide();
+    setBusy(false);
+    if (job->error) {
+        // The outputs may be half-written; drop them and go back to the points.
+        QString message = "Run All failed";
+        try {
+            std::rethrow_exception(job->error);
+        } catch (const std::exception &error) {
+            message += QString(": %1").arg(QString::fromLocal8Bit(error.what()));
+        } catch (...) {
+        }
+        onReset();
+        statusBar()->clearMessage();
+        qDebug() << message;
+        QMessageBox::warning(this, "Run All", message);
+        return;
+    }
+
+    m_adjGraph = std::move(job->adjGraph);
+    m_faces = std::move(job->faces);
+    m_hexahedra = std::move(job->hexahedra);
+    m_glWidget->setFaces(m_faces);
+    m_glWidget->setHexahedra(m_hexahedra);
+    // Steps 2+3 did not run if Step 1 was cancelled.
+    if (!job->steps2and3.step.isEmpty()) m_perfPanel->recordStep(job->steps2and3);
+
+    if (job->status != ReconstructionEngine::StepStatus::Completed) {
+        QString summary = QString("Run All cancelled: kept %1 graph rows, %2 faces and %3 hexahedra found so far")
+                              .arg(m_adjGraph.size()).arg(m_faces.size()).arg(m_hexahedra.size());
+        statusBar()->showMessage(summary);
+        qDebug() << summary;
+        return;
+    }
+    qDebug() << "Run All: found" << m_faces.size() << "faces and reconstructed" << m_hexahedra.size() << "hexahedra.";
+}
+
+// Slot for the Preview button: reconstructs a few small patches spread evenly over the points
+// (see reconstructPreview) and shows them over the full point cloud, with an estimate of the
+// full result. Optionally continues with Run All, keeping the preview up until it finishes.
+void MainWindow::onPreview() {
+    if (m_runAllThread.joinable()) return;
+    onReset();
+    qDebug() << "--- Preview: reconstructing sample patches ---";
+
+    StepStatistics stats;
+    ReconstructionEngine::PreviewResult preview;
+    measureStep("preview", stats, [this, &preview]() { preview = ReconstructionEngine::reconstructPreview(m_points); });
+    m_glWidget->setAdjacencyGraph(preview.adjGraph);
+    m_glWidget->setFaces(preview.faces);
+    m_glWidget->setHexahedra(preview.hexahedra);
+
+    stats.step = "Preview";
+    stats.results = (qint64)preview.hexahedra.size();
+    stats.items = preview.reconstructedPoints;
+    stats.itemUnit = "points";
+    m_perfPanel->recordStep(stats);
+
+    QString summary = QString("Preview: %1 hexahedra in %2 patches (%3 of %4 points) in %5 ms; about %6 expected in total")
+                          .arg(preview.hexahedra.size()).arg(preview.patches).arg(preview.reconstructedPoints)
+                          .arg(m_points.size()).arg(stats.seconds * 1000.0, 0, 'f', 0).arg(preview.estimatedHexahedra, 0, 'f', 0);
+    statusBar()->showMessage(summary);
+    qDebug() << summary;
+
+    if (m_previewThenRunAll->isChecked()) startRunAll();
+}
+
+void MainWindow::setBusy(bool busy) {
+    m_resetButton->setEnabled(!busy);
+    m_runAllButton->setEnabled(!busy);
+    m_previewButton->setEnabled(!busy);
+    m_openAction->setEnabled(!busy);
+    if (busy) {
+        m_step1Button->setEnabled(false);
+        m_step2Button->setEnabled(false);
+        m_step3Button->setEnabled(false);
+    }
+}
+
+// Slot for File > Open: loads a text or binary point file in the background. A sample of the
+// file is shown as soon as it is read; the full point set replaces it when loading completes.
+void MainWindow::onOpenPoints() {
+    QString path = QFileDialog::getOpenFileName(this, "Open Points", QString(),
+                                                "Point files (*.txt *.xyz *.hxp);;All files (*)");
+    if (path.isEmpty() || !m_loader->start(path)) return;
+
+    setBusy(true);
+    m_progressBar->setFormat("%p%");
+    m_progressBar->setValue(0);
+    m_progressBar->show();
+    m_cancelLoadButton->show();
+    statusBar()->showMessage(QString("Loading %1...").arg(QFileInfo(path).fileName()));
+    qDebug() << "--- Loading points from" << path << "---";
+}
+
+void MainWindow::onLoadPreviewReady() {
+    std::vector<MeshPoint> preview = m_loader->takePreview();
+    m_glWidget->reset();
+    m_glWidget->setPoints(preview);
+    statusBar()->showMessage(QString("Loading %1... (showing a preview of %2 points)")
+                                 .arg(QFileInfo(m_loader->path()).fileName()).arg(preview.size()));
+}
+
+void MainWindow::onLoadFinished() {
+    m_progressBar->hide();
+    m_cancelLoadButton->hide();
+    QString fileName = QFileInfo(m_loader->path()).fileName();
+    if (m_loader->succeeded()) {
+        m_points = m_loader->takePoints();
+        statusBar()->showMessage(QString("Loaded %1 points from %2").arg(m_points.size()).arg(fileName));
+        qDebug() << "Loaded" << m_points.size() << "points.";
+    } else if (m_loader->wasCancelled()) {
+        statusBar()->showMessage(QString("Loading %1 cancelled").arg(fileName), 5000);
+    } else {
+        statusBar()->clearMessage();
+        QMessageBox::warning(this, "Open Points", m_loader->errorString());
+    }
+    // Shows the new points, or restores the previous ones over the preview.
+    setBusy(false);
+    onReset();
+}
@@ -2,11 +2,20 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <exception>
+#include <memory>
+#include <thread>
 #include <vector>
+#include "cancellation.h"
 #include "reconstruction_engine.h"
+#include "performance_panel.h"
 
 // Forward declaration
 class GLWidget;
+class PointFileLoader;
+class QAction;
+class QCheckBox;
+class QProgressBar;
 class QPushButton;
 
 class MainWindow : public QMainWindow
@@ -21,9 +30,46 @@ private slots:
     void onStep1_BuildGraph();
     void onStep2_FindFaces();
     void onStep3_BuildHexahedra();
+    void onRunAll();
+    void onPreview();
+    void onRunAllProgress(const QString &stage, int permille);
+    void onRunAllGraphReady();
+    void onRunAllFinished();
+    void onOpenPoints();
+    void onLoadPreviewReady();
+    void onLoadFinished();
+
+signals:
+    // Emitted from the Run all worker thread; connected with queued connections.
+    void runAllProgress(const QString &stage, int permille);
+    void runAllGraphReady();
+    void runAllFinished();
 
 private:
     void setupUI();
+    // Disables every control that starts work or replaces the data while a background job runs.
+    void setBusy(bool busy);
+    // Starts Run all without clearing the view first.
+    void startRunAll();
+
+    /**
+     * @struct RunAllJob
+     * @brief Inputs and outputs of a background Run all. The worker owns each output until it
+     * signals that it is ready; afterwards the UI thread may read it. Only the token and the
+     * progress counter are shared while the job runs.
+     */
+    struct RunAllJob {
+        ReconstructionEngine::CancellationToken cancel;
+        ReconstructionEngine::StepStatus status = ReconstructionEngine::StepStatus::Completed;
+        ReconstructionEngine::ProgressCounter progress;
+        std::vector<MeshPoint> points;
+        AdjacencyGraph adjGraph;
+        std::vector<QuadFace> faces;
+        std::vector<Hexahedron> hexahedra;
+        StepStatistics step1;
+        StepStatistics steps2and3;
+        std::exception_ptr error; // Set if a step threw; the outputs are then incomplete.
+    };
 
     // UI Widgets
     GLWidget *m_glWidget;
@@ -31,6 +77,20 @@ private:
     QPushButton *m_step1Button;
     QPushButton *m_step2Button;
     QPushButton *m_step3Button;
+    QPushButton *m_runAllButton;
+    QPushButton *m_previewButton;
+    QCheckBox *m_previewThenRunAll;
+    PerformancePanel *m_perfPanel;
+    QAction *m_openAction;
+    QProgressBar *m_progressBar;
+    QPushButton *m_cancelLoadButton;
+
+    // Background file loading
+    PointFileLoader *m_loader;
+
+    // Background Run all
+    std::unique_ptr<RunAllJob> m_runAllJob;
+    std::thread m_runAllThread;
 
     // Data containers for the reconstruction process
     std::vector<MeshPoint> m_points;
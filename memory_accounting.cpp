@@ -0,0 +1,188 @@
+#include "memory_accounting.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using namespace ReconstructionEngine;
+
+namespace {
+    // Every block starts with a header holding its size, so that delete can account for it.
+    // 16 bytes keep the alignment malloc guarantees for fundamental types.
+    const size_t kHeaderBytes = 16;
+
+    std::atomic<size_t> g_liveBytes(0);
+    std::atomic<size_t> g_peakBytes(0);
+    std::atomic<size_t> g_stagePeakBytes(0);
+    std::atomic<size_t> g_ceilingBytes(0);
+    std::atomic<uint64_t> g_allocations(0);
+    std::atomic<uint64_t> g_frees(0);
+    std::atomic<const char*> g_stage("");
+
+    void raiseTo(std::atomic<size_t>& peak, size_t value) {
+        size_t current = peak.load(std::memory_order_relaxed);
+        while (current < value && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    void* allocate(size_t size) {
+        // The bytes are reserved before the ceiling is checked, so that concurrent allocations
+        // cannot all pass the check and overshoot it together; a refused one gives them back.
+        size_t live = g_liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        size_t ceiling = g_ceilingBytes.load(std::memory_order_relaxed);
+        if (ceiling != 0 && live > ceiling) {
+            g_liveBytes.fetch_sub(size, std::memory_order_relaxed);
+            throw MemoryCeilingExceeded(currentMemoryStage(), size, live - size, ceiling);
+        }
+        for (;;) {
+            void* block = std::malloc(size + kHeaderBytes);
+            if (block) {
+                *static_cast<size_t*>(block) = size;
+                raiseTo(g_peakBytes, live);
+                raiseTo(g_stagePeakBytes, live);
+                g_allocations.fetch_add(1, std::memory_order_relaxed);
+                return static_cast<char*>(block) + kHeaderBytes;
+            }
+            std::new_handler handler = std::get_new_handler();
+            try {
+                if (!handler) throw std::bad_alloc();
+                handler();
+            } catch (...) {
+                g_liveBytes.fetch_sub(size, std::memory_order_relaxed);
+                throw;
+            }
+        }
+    }
+
+    void release(void* pointer) {
+        if (!pointer) return;
+        char* block = static_cast<char*>(pointer) - kHeaderBytes;
+        g_liveBytes.fetch_sub(*reinterpret_cast<size_t*>(block), std::memory_order_relaxed);
+        g_frees.fetch_add(1, std::memory_order_relaxed);
+        std::free(block);
+    }
+
+    // Resets the kernel's peak RSS to the current RSS (Linux 4.0 or newer).
+    bool resetResidentPeak() {
+#ifdef __linux__
+        FILE* file = std::fopen("/proc/self/clear_refs", "w");
+        if (!file) return false;
+        bool ok = std::fputs("5", file) >= 0;
+        return std::fclose(file) == 0 && ok;
+#else
+        return false;
+#endif
+    }
+} // namespace
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+
+#if defined(__cpp_sized_deallocation)
+void operator delete(void* pointer, std::size_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { release(pointer); }
+#endif
+
+namespace ReconstructionEngine {
+    MemoryCounters memoryCounters() {
+        MemoryCounters counters;
+        counters.liveBytes = g_liveBytes.load(std::memory_order_relaxed);
+        counters.peakBytes = g_peakBytes.load(std::memory_order_relaxed);
+        counters.allocations = g_allocations.load(std::memory_order_relaxed);
+        counters.frees = g_frees.load(std::memory_order_relaxed);
+        return counters;
+    }
+
+    void setMemoryCeiling(size_t bytes) { g_ceilingBytes.store(bytes, std::memory_order_relaxed); }
+    size_t memoryCeiling() { return g_ceilingBytes.load(std::memory_order_relaxed); }
+    const char* currentMemoryStage() { return g_stage.load(std::memory_order_relaxed); }
+
+    size_t residentBytes() {
+#ifdef __linux__
+        FILE* file = std::fopen("/proc/self/statm", "r");
+        if (!file) return 0;
+        unsigned long pages = 0;
+        bool ok = std::fscanf(file, "%*lu %lu", &pages) == 1;
+        std::fclose(file);
+        return ok ? (size_t)pages * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#else
+        return 0;
+#endif
+    }
+
+    size_t residentPeakBytes() {
+#ifdef __linux__
+        FILE* file = std::fopen("/proc/self/status", "r");
+        if (!file) return 0;
+        char line[256];
+        size_t kilobytes = 0;
+        while (std::fgets(line, sizeof(line), file)) {
+            if (std::strncmp(line, "VmHWM:", 6) == 0) {
+                kilobytes = std::strtoul(line + 6, nullptr, 10);
+                break;
+            }
+        }
+        std::fclose(file);
+        return kilobytes * 1024;
+#else
+        return 0;
+#endif
+    }
+
+    MemoryCeilingExceeded::MemoryCeilingExceeded(const char* stage, size_t requestedBytes, size_t liveBytes, size_t ceilingBytes)
+        : m_stage(stage), m_requestedBytes(requestedBytes), m_liveBytes(liveBytes), m_ceilingBytes(ceilingBytes) {
+        std::snprintf(m_message, sizeof(m_message), "memory ceiling of %zu bytes exceeded in stage '%s': %zu bytes live, %zu requested",
+                      ceilingBytes, stage && *stage ? stage : "(none)", liveBytes, requestedBytes);
+    }
+
+    MemoryScope::MemoryScope(const char* stage) : m_finished(false) {
+        m_result.stage = stage;
+        m_start = memoryCounters();
+        m_outerStage = g_stage.exchange(stage, std::memory_order_relaxed);
+        m_outerPeak = g_stagePeakBytes.exchange(m_start.liveBytes, std::memory_order_relaxed);
+        resetResidentPeak();
+    }
+
+    MemoryScope::~MemoryScope() { finish(); }
+
+    StageMemory MemoryScope::finish() {
+        if (m_finished) return m_result;
+        m_finished = true;
+        MemoryCounters end = memoryCounters();
+        m_result.startBytes = m_start.liveBytes;
+        m_result.endBytes = end.liveBytes;
+        m_result.peakBytes = g_stagePeakBytes.load(std::memory_order_relaxed);
+        m_result.allocations = end.allocations - m_start.allocations;
+        m_result.frees = end.frees - m_start.frees;
+        m_result.residentPeakBytes = residentPeakBytes();
+        g_stage.store(m_outerStage, std::memory_order_relaxed);
+        // The outer stage's peak includes this one.
+        g_stagePeakBytes.store(std::max(m_outerPeak, m_result.peakBytes), std::memory_order_relaxed);
+        return m_result;
+    }
+} // namespace ReconstructionEngine
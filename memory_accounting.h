@@ -0,0 +1,116 @@
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Allocation accounting for the engine. memory_accounting.cpp replaces the global operator
+// new/delete with counting versions, so it must be linked into any program that uses this
+// header (the hexrecon tool does). The counters are process-wide and see every C++
+// allocation, including those of the standard containers behind the adjacency graph and the
+// face and cell lists. Qt containers (the QSet dedup tables) allocate with malloc and are
+// only visible in the resident-set figures, so a limit meant to cover them has to watch
+// residentBytes() as well as setting the ceiling.
+
+namespace ReconstructionEngine {
+    /**
+     * @struct MemoryCounters
+     * @brief Process-wide totals of the counting allocator.
+     */
+    struct MemoryCounters {
+        size_t liveBytes = 0;
+        size_t peakBytes = 0;
+        uint64_t allocations = 0;
+        uint64_t frees = 0;
+    };
+
+    MemoryCounters memoryCounters();
+
+    /**
+     * @brief Limits the live bytes of the counting allocator (0 = no limit). An allocation
+     * that would exceed it throws MemoryCeilingExceeded (nothrow new returns null instead).
+     * Memory allocated with malloc, such as that of Qt containers, is not capped.
+     */
+    void setMemoryCeiling(size_t bytes);
+    size_t memoryCeiling();
+
+    // The stage of the innermost MemoryScope, or "" outside of one.
+    const char* currentMemoryStage();
+
+    /**
+     * @brief Current resident set size of the process in bytes (Linux), or 0 if unknown. Reads
+     * /proc without allocating through operator new.
+     */
+    size_t residentBytes();
+
+    /**
+     * @brief Peak resident set size of the process in bytes (Linux VmHWM), or 0 if unknown.
+     */
+    size_t residentPeakBytes();
+
+    /**
+     * @class MemoryCeilingExceeded
+     * @brief Thrown by operator new when the ceiling set with setMemoryCeiling is reached.
+     */
+    class MemoryCeilingExceeded : public std::bad_alloc {
+    public:
+        MemoryCeilingExceeded(const char* stage, size_t requestedBytes, size_t liveBytes, size_t ceilingBytes);
+
+        const char* what() const noexcept override { return m_message; }
+        const char* stage() const { return m_stage; }
+        size_t requestedBytes() const { return m_requestedBytes; }
+        size_t liveBytes() const { return m_liveBytes; }
+        size_t ceilingBytes() const { return m_ceilingBytes; }
+
+    private:
+        // Built without allocating, since it is created inside operator new.
+        char m_message[192];
+        const char* m_stage;
+        size_t m_requestedBytes;
+        size_t m_liveBytes;
+        size_t m_ceilingBytes;
+    };
+
+    /**
+     * @struct StageMemory
+     * @brief Allocation activity of one MemoryScope.
+     */
+    struct StageMemory {
+        const char* stage = "";
+        size_t startBytes = 0;      // Live bytes when the stage began.
+        size_t endBytes = 0;        // Live bytes when it ended; the difference is what the stage kept.
+        size_t peakBytes = 0;       // Highest live bytes during the stage.
+        uint64_t allocations = 0;
+        uint64_t frees = 0;
+        size_t residentPeakBytes = 0; // Peak RSS during the stage where the kernel can reset it, else of the process.
+    };
+
+    /**
+     * @class MemoryScope
+     * @brief Attributes the allocations made while it is alive, on any thread, to one stage.
+     *
+     * Scopes nest; an inner scope's peak also counts towards the outer one. `stage` must be a
+     * string literal or otherwise outlive the scope.
+     */
+    class MemoryScope {
+    public:
+        explicit MemoryScope(const char* stage);
+        ~MemoryScope();
+
+        // Stops the scope and returns its figures; later calls return the same figures.
+        StageMemory finish();
+
+    private:
+        MemoryScope(const MemoryScope&) = delete;
+        MemoryScope& operator=(const MemoryScope&) = delete;
+
+        StageMemory m_result;
+        MemoryCounters m_start;
+        const char* m_outerStage;
+        size_t m_outerPeak;
+        bool m_finished;
+    };
+} // namespace ReconstructionEngine
+
+#endif // MEMORY_ACCOUNTING_H
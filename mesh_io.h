@@ -0,0 +1,162 @@
+#ifndef MESH_IO_H
+#define MESH_IO_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include "reconstruction_engine.h"
+#include "bulk_io.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @brief Writes points and hexahedra as a legacy ASCII VTK unstructured grid.
+     *
+     * buildHexahedra's corner topology matches VTK_HEXAHEDRON (cell type 12): 0-3 and 4-7 are
+     * opposite faces and corner k+4 is linked to corner k. Its winding is that of the face Step 2
+     * found, though, so where the normal of face 0-3 points away from corners 4-7 both faces
+     * are written reversed (corners 1<->3 and 5<->7); otherwise ParaView shows an inverted cell.
+     */
+    inline bool saveHexMeshVtk(const QString& path, const std::vector<MeshPoint>& points, const std::vector<Hexahedron>& hexahedra,
+                               QString* errorMessage = nullptr) {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            if (errorMessage) *errorMessage = QString("Cannot open %1: %2").arg(path, file.errorString());
+            return false;
+        }
+
+        // Output is assembled in large chunks to keep the number of write calls low.
+        const int kFlushSize = 1 << 20;
+        QByteArray buffer;
+        buffer.reserve(kFlushSize + 256);
+        bool ok = true;
+        auto flush = [&](bool force) {
+            if (ok && (force || buffer.size() >= kFlushSize)) {
+                ok = file.write(buffer) == buffer.size();
+                buffer.clear();
+            }
+        };
+
+        buffer += "# vtk DataFile Version 3.0\nHexReconstruction\nASCII\nDATASET UNSTRUCTURED_GRID\n";
+        buffer += "POINTS " + QByteArray::number((qulonglong)points.size()) + " float\n";
+        // 9 significant digits round-trip any float; the default 6 would not.
+        auto coordinate = [](float v) { return QByteArray::number((double)v, 'g', 9); };
+        for (const MeshPoint& p : points) {
+            buffer += coordinate(p.pos.x()) + ' ' + coordinate(p.pos.y()) + ' ' + coordinate(p.pos.z()) + '\n';
+            flush(false);
+        }
+
+        buffer += "CELLS " + QByteArray::number((qulonglong)hexahedra.size()) + ' ' +
+                  QByteArray::number((qulonglong)hexahedra.size() * 9) + '\n';
+        for (Hexahedron hex : hexahedra) {
+            const Vector3& c0 = points[hex[0]].pos;
+            Vector3 normal = QVector3D::crossProduct(points[hex[1]].pos - c0, points[hex[3]].pos - c0);
+            if (QVector3D::dotProduct(normal, points[hex[4]].pos - c0) < 0.0f) {
+                std::swap(hex[1], hex[3]);
+                std::swap(hex[5], hex[7]);
+            }
+            buffer += '8';
+            for (int idx : hex) buffer += ' ' + QByteArray::number(idx);
+            buffer += '\n';
+            flush(false);
+        }
+
+        buffer += "CELL_TYPES " + QByteArray::number((qulonglong)hexahedra.size()) + '\n';
+        for (size_t h = 0; h < hexahedra.size(); ++h) {
+            buffer += "12\n";
+            flush(false);
+        }
+        flush(true);
+
+        if (!ok && errorMessage) *errorMessage = QString("Cannot write %1: %2").arg(path, file.errorString());
+        return ok;
+    }
+
+    /**
+     * @brief Writes points and hexahedra in the binary mesh format (.hxm).
+     *
+     * Layout (little-endian): the magic "HXM1", uint64 point and hexahedron counts, the points
+     * as three float32 each, then the hexahedra as eight int32 corner indices each. The whole
+     * file is assembled in memory and written in one bulk transfer through `backend`.
+     */
+    inline bool saveHexMeshBinary(const QString& path, const std::vector<MeshPoint>& points, const std::vector<Hexahedron>& hexahedra,
+                                  QString* errorMessage = nullptr, IoBackend backend = IoBackend::Synchronous) {
+        const size_t kHeaderSize = 20;
+        IoBuffer buffer;
+        buffer.resize(kHeaderSize + points.size() * 12 + hexahedra.size() * 32);
+        std::memcpy(buffer.data(), "HXM1", 4);
+        storeLittleEndian(buffer.data() + 4, (uint64_t)points.size());
+        storeLittleEndian(buffer.data() + 12, (uint64_t)hexahedra.size());
+
+        char* cursor = buffer.data() + kHeaderSize;
+        for (const MeshPoint& p : points) {
+            storeLittleEndian(cursor, p.pos.x());
+            storeLittleEndian(cursor + 4, p.pos.y());
+            storeLittleEndian(cursor + 8, p.pos.z());
+            cursor += 12;
+        }
+        for (const Hexahedron& hex : hexahedra) {
+            for (int k = 0; k < 8; ++k) storeLittleEndian(cursor + 4 * k, (int32_t)hex[k]);
+            cursor += 32;
+        }
+        return writeFileBulk(path, buffer.data(), buffer.size(), backend, errorMessage);
+    }
+
+    /**
+     * @brief Reads a mesh written by saveHexMeshBinary. Point positions are loaded with
+     * required_neighbors set to 0; corner indices are checked against the point count.
+     */
+    inline bool loadHexMeshBinary(const QString& path, std::vector<MeshPoint>& points, std::vector<Hexahedron>& hexahedra,
+                                  QString* errorMessage = nullptr, IoBackend backend = IoBackend::Synchronous) {
+        points.clear();
+        hexahedra.clear();
+        IoBuffer buffer;
+        if (!readFileBulk(path, buffer, backend, errorMessage)) return false;
+
+        const size_t kHeaderSize = 20;
+        uint64_t counts[2] = {0, 0};
+        if (buffer.size() >= kHeaderSize) {
+            counts[0] = loadLittleEndian<uint64_t>(buffer.data() + 4);
+            counts[1] = loadLittleEndian<uint64_t>(buffer.data() + 12);
+        }
+        bool ok = buffer.size() >= kHeaderSize && std::memcmp(buffer.data(), "HXM1", 4) == 0 &&
+                  counts[0] <= (buffer.size() - kHeaderSize) / 12 &&
+                  counts[1] == (buffer.size() - kHeaderSize - counts[0] * 12) / 32 &&
+                  (buffer.size() - kHeaderSize - counts[0] * 12) % 32 == 0;
+
+        const char* cursor = buffer.data() + kHeaderSize;
+        if (ok) {
+            points.resize((size_t)counts[0]);
+            for (MeshPoint& p : points) {
+                p.pos = Vector3(loadLittleEndian<float>(cursor), loadLittleEndian<float>(cursor + 4), loadLittleEndian<float>(cursor + 8));
+                p.required_neighbors = 0;
+                cursor += 12;
+            }
+            hexahedra.resize((size_t)counts[1]);
+            for (Hexahedron& hex : hexahedra) {
+                for (int k = 0; k < 8; ++k) {
+                    int32_t corner = loadLittleEndian<int32_t>(cursor + 4 * k);
+                    hex[k] = corner;
+                    ok = ok && corner >= 0 && (uint64_t)corner < counts[0];
+                }
+                cursor += 32;
+            }
+        }
+        if (!ok) {
+            points.clear();
+            hexahedra.clear();
+            if (errorMessage) *errorMessage = QString("%1: not a valid binary mesh file").arg(path);
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Saves a mesh in the format given by the suffix: binary for .hxm, legacy VTK otherwise.
+     */
+    inline bool saveHexMeshFile(const QString& path, const std::vector<MeshPoint>& points, const std::vector<Hexahedron>& hexahedra,
+                                QString* errorMessage = nullptr, IoBackend backend = IoBackend::Synchronous) {
+        if (path.endsWith(".hxm", Qt::CaseInsensitive)) return saveHexMeshBinary(path, points, hexahedra, errorMessage, backend);
+        return saveHexMeshVtk(path, points, hexahedra, errorMessage);
+    }
+} // namespace ReconstructionEngine
+
+#endif // MESH_IO_H
@@ -0,0 +1,89 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace ReconstructionEngine {
+    inline std::atomic<int>& threadCountSetting() {
+        static std::atomic<int> count(0);
+        return count;
+    }
+
+    /**
+     * @brief Limits the number of worker threads used by the parallel engine paths (0 = all cores).
+     */
+    inline void setThreadCount(int count) { threadCountSetting().store(std::max(count, 0)); }
+
+    inline int threadCount() {
+        int count = threadCountSetting().load();
+        if (count > 0) return count;
+        return std::max(1, (int)std::thread::hardware_concurrency());
+    }
+
+    /**
+     * @brief Splits [begin, end) into one contiguous chunk per worker and runs fn(chunkBegin, chunkEnd, worker).
+     *
+     * The calling thread processes the first chunk itself; small ranges run entirely inline.
+     * If fn throws, the remaining chunks still finish and the first exception (by chunk) is
+     * rethrown on the calling thread.
+     */
+    template <typename Fn>
+    inline void parallelForChunks(int begin, int end, Fn fn, int minChunk = 64) {
+        int total = end - begin;
+        if (total <= 0) return;
+        int workers = std::min(threadCount(), std::max(1, total / std::max(minChunk, 1)));
+        if (workers <= 1) {
+            fn(begin, end, 0);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> errors(workers);
+        threads.reserve(workers - 1);
+        int chunk = (total + workers - 1) / workers;
+        for (int w = 1; w < workers; ++w) {
+            int chunkBegin = begin + w * chunk;
+            int chunkEnd = std::min(end, chunkBegin + chunk);
+            if (chunkBegin >= chunkEnd) break;
+            std::exception_ptr* error = &errors[w];
+            try {
+                threads.emplace_back([=]() {
+                    try {
+                        fn(chunkBegin, chunkEnd, w);
+                    } catch (...) {
+                        *error = std::current_exception();
+                    }
+                });
+            } catch (...) {
+                // Starting a thread can fail (e.g. under a memory ceiling); the rest is not run.
+                *error = std::current_exception();
+                break;
+            }
+        }
+        try {
+            fn(begin, std::min(end, begin + chunk), 0);
+        } catch (...) {
+            errors[0] = std::current_exception();
+        }
+        for (std::thread& t : threads) t.join();
+        for (const std::exception_ptr& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief Runs fn(i) for every i in [begin, end) across the worker threads.
+     */
+    template <typename Fn>
+    inline void parallelFor(int begin, int end, Fn fn, int minChunk = 64) {
+        parallelForChunks(begin, end, [&fn](int chunkBegin, int chunkEnd, int) {
+            for (int i = chunkBegin; i < chunkEnd; ++i) fn(i);
+        }, minChunk);
+    }
+} // namespace ReconstructionEngine
+
+#endif // PARALLEL_H
@@ -0,0 +1,190 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <QHash>
+#include "reconstruction_engine.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @struct SweepResult
+     * @brief Face and hexahedron counts obtained for one tolerance setting.
+     */
+    struct SweepResult {
+        FaceTolerances tolerances;
+        int faces;
+        int hexahedra;
+    };
+
+    /**
+     * @class ToleranceSweep
+     * @brief Evaluates Steps 2-3 for many tolerance settings while running Step 1 only once.
+     *
+     * The constructor builds the adjacency graph and enumerates every 4-cycle candidate once,
+     * caching its coplanarity volume and edge/diagonal lengths. evaluate() then decides face
+     * acceptance for all settings from the cached geometry, and pairs the faces accepted by
+     * any setting a single time. The counts match running findValidFaces and buildHexahedra
+     * separately with each setting.
+     */
+    class ToleranceSweep {
+    public:
+        explicit ToleranceSweep(const std::vector<MeshPoint>& points) : m_adjGraph(buildAdjacencyGraph(points)) {
+            QHash<QVector<int>, int> keyIds;
+            for (int p0_idx = 0; p0_idx < (int)points.size(); ++p0_idx) {
+                if (!m_adjGraph.count(p0_idx)) continue;
+                std::vector<int> neighbors(m_adjGraph.at(p0_idx).begin(), m_adjGraph.at(p0_idx).end());
+
+                // Same traversal as collectFacesFrom, so candidates appear in findValidFaces order.
+                for (size_t i = 0; i < neighbors.size(); ++i) {
+                    for (size_t j = i + 1; j < neighbors.size(); ++j) {
+                        int p1_idx = neighbors[i];
+                        int p3_idx = neighbors[j];
+                        if (!m_adjGraph.count(p1_idx) || !m_adjGraph.count(p3_idx)) continue;
+                        for (int p2_idx : m_adjGraph.at(p1_idx)) {
+                            if (p2_idx == p0_idx || !m_adjGraph.at(p3_idx).count(p2_idx)) continue;
+                            addCandidate(points, {p0_idx, p1_idx, p2_idx, p3_idx}, keyIds);
+                        }
+                    }
+                }
+            }
+        }
+
+        const AdjacencyGraph& adjacencyGraph() const { return m_adjGraph; }
+        int candidateCount() const { return (int)m_candidates.size(); }
+
+        std::vector<SweepResult> evaluate(const std::vector<FaceTolerances>& settings) const {
+            const int keyCount = (int)m_keys.size();
+            const int settingCount = (int)settings.size();
+
+            // firstAccepted[s][k]: position of the first candidate of key k accepted by setting s.
+            std::vector<std::vector<int>> firstAccepted(settingCount, std::vector<int>(keyCount, -1));
+            std::vector<char> acceptedByAny(keyCount, 0);
+            std::vector<SweepResult> results(settingCount);
+            for (int s = 0; s < settingCount; ++s) {
+                results[s].tolerances = settings[s];
+                results[s].faces = 0;
+                results[s].hexahedra = 0;
+                for (int c = 0; c < (int)m_candidates.size(); ++c) {
+                    const Candidate& candidate = m_candidates[c];
+                    if (firstAccepted[s][candidate.key] >= 0 || !accepts(candidate, settings[s])) continue;
+                    firstAccepted[s][candidate.key] = c;
+                    acceptedByAny[candidate.key] = 1;
+                    ++results[s].faces;
+                }
+            }
+
+            // Pair every face accepted by some setting once. Connecting edges are looked up from
+            // the earlier face to the later one, so both directions are tested and each setting
+            // picks the one matching its own face order.
+            std::vector<int> keys;
+            for (int k = 0; k < keyCount; ++k) {
+                if (acceptedByAny[k]) keys.push_back(k);
+            }
+            QHash<QVector<int>, int> hexIds;
+            std::vector<HexCandidate> hexCandidates;
+            for (size_t a = 0; a < keys.size(); ++a) {
+                for (size_t b = a + 1; b < keys.size(); ++b) {
+                    const QuadFace& faceA = m_keys[keys[a]];
+                    const QuadFace& faceB = m_keys[keys[b]];
+                    bool forward = connectsAsHexahedron(faceA, faceB);
+                    bool backward = connectsAsHexahedron(faceB, faceA);
+                    if (!forward && !backward) continue;
+
+                    QVector<int> signature;
+                    for (int p : faceA) signature.append(p);
+                    for (int p : faceB) signature.append(p);
+                    std::sort(signature.begin(), signature.end());
+                    auto id = hexIds.find(signature);
+                    if (id == hexIds.end()) id = hexIds.insert(signature, hexIds.size());
+
+                    HexCandidate candidate = {keys[a], keys[b], forward, backward, id.value()};
+                    hexCandidates.push_back(candidate);
+                }
+            }
+
+            for (int s = 0; s < settingCount; ++s) {
+                const std::vector<int>& order = firstAccepted[s];
+                std::vector<char> found(hexIds.size(), 0);
+                for (const HexCandidate& candidate : hexCandidates) {
+                    int posA = order[candidate.keyA];
+                    int posB = order[candidate.keyB];
+                    if (posA < 0 || posB < 0 || found[candidate.hexId]) continue;
+                    if (posA < posB ? candidate.forward : candidate.backward) {
+                        found[candidate.hexId] = 1;
+                        ++results[s].hexahedra;
+                    }
+                }
+            }
+            return results;
+        }
+
+    private:
+        struct Candidate {
+            int key;         // Index of the candidate's vertex set in m_keys.
+            float volume;    // |triple product| of the edge vectors.
+            float maxEdgeSq;
+            float minDiagSq;
+        };
+
+        struct HexCandidate {
+            int keyA, keyB;
+            bool forward;    // Valid when keyA's face comes first.
+            bool backward;   // Valid when keyB's face comes first.
+            int hexId;
+        };
+
+        static bool accepts(const Candidate& candidate, const FaceTolerances& tolerances) {
+            return candidate.volume < tolerances.coplanarity && candidate.minDiagSq > candidate.maxEdgeSq * tolerances.diagonalRatio;
+        }
+
+        void addCandidate(const std::vector<MeshPoint>& points, const QuadFace& face, QHash<QVector<int>, int>& keyIds) {
+            const Vector3& p0 = points[face[0]].pos;
+            const Vector3& p1 = points[face[1]].pos;
+            const Vector3& p2 = points[face[2]].pos;
+            const Vector3& p3 = points[face[3]].pos;
+
+            Candidate candidate;
+            candidate.volume = std::abs(QVector3D::dotProduct(p1 - p0, QVector3D::crossProduct(p2 - p0, p3 - p0)));
+            candidate.maxEdgeSq = std::max({(p0 - p1).lengthSquared(), (p1 - p2).lengthSquared(),
+                                            (p2 - p3).lengthSquared(), (p3 - p0).lengthSquared()});
+            candidate.minDiagSq = std::min((p0 - p2).lengthSquared(), (p1 - p3).lengthSquared());
+
+            QVector<int> sortedFace = {face[0], face[1], face[2], face[3]};
+            std::sort(sortedFace.begin(), sortedFace.end());
+            auto id = keyIds.find(sortedFace);
+            if (id == keyIds.end()) {
+                id = keyIds.insert(sortedFace, (int)m_keys.size());
+                m_keys.push_back(face);
+            }
+            candidate.key = id.value();
+            m_candidates.push_back(candidate);
+        }
+
+        // The opposite-face test of buildHexahedra: disjoint faces joined by four edges, one per vertex.
+        bool connectsAsHexahedron(const QuadFace& face1, const QuadFace& face2) const {
+            for (int p : face1) {
+                if (std::find(face2.begin(), face2.end(), p) != face2.end()) return false;
+            }
+            int edges = 0;
+            bool usedInFace2[4] = {false, false, false, false};
+            for (int p1 : face1) {
+                if (!m_adjGraph.count(p1)) continue;
+                int linked = 0;
+                for (int k = 0; k < 4; ++k) {
+                    if (m_adjGraph.at(p1).count(face2[k])) {
+                        ++linked;
+                        ++edges;
+                        usedInFace2[k] = true;
+                    }
+                }
+                if (linked != 1) return false;
+            }
+            return edges == 4 && usedInFace2[0] && usedInFace2[1] && usedInFace2[2] && usedInFace2[3];
+        }
+
+        AdjacencyGraph m_adjGraph;
+        std::vector<QuadFace> m_keys;        // One representative cycle per distinct vertex set.
+        std::vector<Candidate> m_candidates; // Every 4-cycle, in findValidFaces traversal order.
+    };
+} // namespace ReconstructionEngine
+
+#endif // PARAMETER_SWEEP_H
@@ -0,0 +1,160 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <QString>
+#include "reconstruction_engine.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ReconstructionEngine {
+    enum PerfEvent {
+        PerfCycles,
+        PerfInstructions,
+        PerfCacheMisses,  // The kernel's generic cache-miss event, i.e. last-level cache misses.
+        PerfBranchMisses,
+        PerfEventCount
+    };
+
+    /**
+     * @struct PerfReading
+     * @brief Counter values of one measured interval. Values are scaled up if the kernel had
+     * to multiplex the counters; `valid` is false for events the CPU or kernel does not offer.
+     */
+    struct PerfReading {
+        uint64_t values[PerfEventCount] = {0, 0, 0, 0};
+        bool valid[PerfEventCount] = {false, false, false, false};
+
+        double ipc() const {
+            return valid[PerfCycles] && valid[PerfInstructions] && values[PerfCycles] ? (double)values[PerfInstructions] / values[PerfCycles] : 0.0;
+        }
+    };
+
+    /**
+     * @class PerfCounters
+     * @brief Hardware counters (cycles, instructions, LLC misses, branch misses) of the calling
+     * thread and of every thread it starts afterwards, read through perf_event_open. Linux only.
+     *
+     * Create it before the engine spawns its workers; the counts of worker threads are folded
+     * in when they exit, so read after they are joined (parallelFor does). User-space events
+     * only, so it works with the default perf_event_paranoid setting of 2. Elsewhere, or if
+     * the kernel refuses, isAvailable() is false and errorString() says why.
+     */
+    class PerfCounters {
+    public:
+        PerfCounters() {
+            for (int e = 0; e < PerfEventCount; ++e) m_fds[e] = -1;
+#ifdef __linux__
+            static const uint64_t kConfigs[PerfEventCount] = {
+                PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+            };
+            for (int e = 0; e < PerfEventCount; ++e) {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = kConfigs[e];
+                attr.disabled = 1;
+                attr.inherit = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                m_fds[e] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+                if (m_fds[e] < 0 && m_error.isEmpty()) {
+                    int error = errno;
+                    m_error = QString("perf_event_open failed: %1").arg(std::strerror(error));
+                    if (error == EACCES || error == EPERM) m_error += " (see /proc/sys/kernel/perf_event_paranoid)";
+                    if (error == ENOENT || error == EOPNOTSUPP) m_error += " (no hardware counters, e.g. in a virtual machine)";
+                }
+            }
+#else
+            m_error = "hardware performance counters are only supported on Linux";
+#endif
+        }
+
+        ~PerfCounters() {
+#ifdef __linux__
+            for (int e = 0; e < PerfEventCount; ++e) {
+                if (m_fds[e] >= 0) close(m_fds[e]);
+            }
+#endif
+        }
+
+        // True if at least one event could be opened.
+        bool isAvailable() const {
+            for (int e = 0; e < PerfEventCount; ++e) {
+                if (m_fds[e] >= 0) return true;
+            }
+            return false;
+        }
+
+        const QString& errorString() const { return m_error; }
+
+        void start() {
+#ifdef __linux__
+            for (int e = 0; e < PerfEventCount; ++e) {
+                if (m_fds[e] < 0) continue;
+                ioctl(m_fds[e], PERF_EVENT_IOC_RESET, 0);
+                ioctl(m_fds[e], PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        PerfReading stop() {
+            PerfReading reading;
+#ifdef __linux__
+            for (int e = 0; e < PerfEventCount; ++e) {
+                if (m_fds[e] >= 0) ioctl(m_fds[e], PERF_EVENT_IOC_DISABLE, 0);
+            }
+            for (int e = 0; e < PerfEventCount; ++e) {
+                uint64_t data[3]; // value, time enabled, time running
+                if (m_fds[e] < 0 || read(m_fds[e], data, sizeof(data)) != (ssize_t)sizeof(data) || data[2] == 0) continue;
+                reading.values[e] = data[2] < data[1] ? (uint64_t)((double)data[0] * data[1] / data[2]) : data[0];
+                reading.valid[e] = true;
+            }
+#endif
+            return reading;
+        }
+
+    private:
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        int m_fds[PerfEventCount];
+        QString m_error;
+    };
+
+    // --- Work units per stage, to normalize counter values ---
+
+    // Step 1 computes one distance per ordered pair of points.
+    inline uint64_t adjacencyCandidateCount(size_t pointCount) { return pointCount < 2 ? 0 : (uint64_t)pointCount * (pointCount - 1); }
+
+    /**
+     * @brief The number of (p0, p1, p3, p2) paths that Step 2 examines, i.e. the iterations of
+     * its innermost loop.
+     */
+    template <typename Graph>
+    inline uint64_t faceCandidateCount(const Graph& adjGraph, int pointCount) {
+        uint64_t candidates = 0;
+        std::vector<int> neighbors;
+        for (int p0 = 0; p0 < pointCount; ++p0) {
+            neighbors.clear();
+            forEachNeighbor(adjGraph, p0, [&neighbors](int n) { neighbors.push_back(n); });
+            for (size_t i = 0; i < neighbors.size(); ++i) {
+                uint64_t degree = 0;
+                forEachNeighbor(adjGraph, neighbors[i], [&degree](int) { ++degree; });
+                candidates += degree * (neighbors.size() - 1 - i);
+            }
+        }
+        return candidates;
+    }
+} // namespace ReconstructionEngine
+
+#endif // PERF_COUNTERS_H
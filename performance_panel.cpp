@@ -0,0 +1,101 @@
+#include "performance_panel.h"
+#include "glwidget.h"
+#include <QHeaderView>
+#include <QLabel>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace {
+    const int kRefreshIntervalMs = 250;
+
+    enum StepColumn { ColumnStep, ColumnTime, ColumnThroughput, ColumnCandidates, ColumnResults, ColumnKept, ColumnPeak, ColumnCount };
+
+    QString formatMegabytes(double bytes) { return QString::number(bytes / 1048576.0, 'f', 1) + " MB"; }
+
+    // 1234567 -> "1.23M"; keeps the funnel columns narrow.
+    QString formatCount(double count) {
+        if (count >= 1e9) return QString::number(count / 1e9, 'f', 2) + "G";
+        if (count >= 1e6) return QString::number(count / 1e6, 'f', 2) + "M";
+        if (count >= 1e4) return QString::number(count / 1e3, 'f', 1) + "k";
+        return QString::number(count, 'f', 0);
+    }
+}
+
+PerformancePanel::PerformancePanel(GLWidget *glWidget, QWidget *parent)
+    : QDockWidget("Performance", parent), m_glWidget(glWidget) {
+    setObjectName("performancePanel");
+
+    m_stepTable = new QTableWidget(0, ColumnCount, this);
+    m_stepTable->setHorizontalHeaderLabels({"Step", "Time", "Throughput", "Candidates", "Results", "Kept", "Peak"});
+    m_stepTable->verticalHeader()->hide();
+    m_stepTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_stepTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_stepTable->setSelectionMode(QAbstractItemView::NoSelection);
+
+    m_memoryLabel = new QLabel(this);
+    m_frameLabel = new QLabel(this);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->addWidget(m_stepTable, 1);
+    layout->addWidget(m_memoryLabel);
+    layout->addWidget(m_frameLabel);
+    QWidget *contents = new QWidget(this);
+    contents->setLayout(layout);
+    setWidget(contents);
+
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(kRefreshIntervalMs);
+    connect(m_refreshTimer, &QTimer::timeout, this, &PerformancePanel::refreshLiveValues);
+    // Only poll while someone can see the values.
+    connect(this, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) {
+            refreshLiveValues();
+            m_refreshTimer->start();
+        } else {
+            m_refreshTimer->stop();
+        }
+    });
+    refreshLiveValues();
+}
+
+void PerformancePanel::recordStep(const StepStatistics &stats) {
+    int row = 0;
+    while (row < m_stepTable->rowCount() && m_stepTable->item(row, ColumnStep)->text() != stats.step) ++row;
+    if (row == m_stepTable->rowCount()) m_stepTable->insertRow(row);
+
+    double throughput = stats.seconds > 0.0 ? stats.items / stats.seconds : 0.0;
+    const QString cells[ColumnCount] = {
+        stats.step,
+        QString::number(stats.seconds * 1000.0, 'f', 1) + " ms",
+        formatCount(throughput) + " " + stats.itemUnit + "/s",
+        formatCount((double)stats.candidates),
+        formatCount((double)stats.results),
+        formatMegabytes((double)stats.memory.endBytes - (double)stats.memory.startBytes),
+        formatMegabytes((double)stats.memory.peakBytes)
+    };
+    for (int column = 0; column < ColumnCount; ++column) {
+        QTableWidgetItem *item = new QTableWidgetItem(cells[column]);
+        if (column != ColumnStep) item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        m_stepTable->setItem(row, column, item);
+    }
+    if (stats.candidates > 0) {
+        m_stepTable->item(row, ColumnResults)->setToolTip(
+            QString("%1% of the candidates").arg(100.0 * stats.results / stats.candidates, 0, 'g', 3));
+    }
+}
+
+void PerformancePanel::clearSteps() { m_stepTable->setRowCount(0); }
+
+void PerformancePanel::refreshLiveValues() {
+    ReconstructionEngine::MemoryCounters counters = ReconstructionEngine::memoryCounters();
+    m_memoryLabel->setText(QString("Memory: %1 live, %2 peak, %3 allocations; resident peak %4")
+                               .arg(formatMegabytes((double)counters.liveBytes))
+                               .arg(formatMegabytes((double)counters.peakBytes))
+                               .arg(formatCount((double)counters.allocations))
+                               .arg(formatMegabytes((double)ReconstructionEngine::residentPeakBytes())));
+    m_frameLabel->setText(QString("3D view: %1 ms last frame, %2 ms recent average (%3 frames drawn)")
+                              .arg(m_glWidget->lastFrameTimeMs(), 0, 'f', 2)
+                              .arg(m_glWidget->averageFrameTimeMs(), 0, 'f', 2)
+                              .arg(m_glWidget->frameCount()));
+}
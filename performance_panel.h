@@ -0,0 +1,57 @@
+#ifndef PERFORMANCE_PANEL_H
+#define PERFORMANCE_PANEL_H
+
+#include <QDockWidget>
+#include <QString>
+#include "memory_accounting.h"
+
+class GLWidget;
+class QLabel;
+class QTableWidget;
+class QTimer;
+
+/**
+ * @struct StepStatistics
+ * @brief What the performance panel shows for one completed step.
+ */
+struct StepStatistics {
+    QString step;              // Row label, e.g. "Step 2".
+    double seconds = 0.0;
+    quint64 candidates = 0;    // Work items examined: point pairs, 4-cycle paths or face pairs.
+    qint64 results = 0;        // Edges, faces or hexahedra produced.
+    qint64 items = 0;          // What the throughput is measured in (points, faces or hexahedra) ...
+    QString itemUnit;          // ... and its unit, e.g. "points".
+    ReconstructionEngine::StageMemory memory;
+};
+
+/**
+ * @class PerformancePanel
+ * @brief A dock showing the time, throughput, candidate funnel and memory of each step, the
+ * allocator totals and the frame time of the 3D view.
+ *
+ * Steps report their figures once when they finish (recordStep); everything else is polled
+ * from the allocator counters and the GLWidget on a timer while the panel is visible, so the
+ * engine itself does no extra work for it.
+ */
+class PerformancePanel : public QDockWidget
+{
+    Q_OBJECT
+public:
+    explicit PerformancePanel(GLWidget *glWidget, QWidget *parent = nullptr);
+
+    // Adds the row of a finished step, replacing an earlier row with the same label.
+    void recordStep(const StepStatistics &stats);
+    void clearSteps();
+
+private slots:
+    void refreshLiveValues();
+
+private:
+    GLWidget *m_glWidget;
+    QTableWidget *m_stepTable;
+    QLabel *m_memoryLabel;
+    QLabel *m_frameLabel;
+    QTimer *m_refreshTimer;
+};
+
+#endif // PERFORMANCE_PANEL_H
@@ -0,0 +1,201 @@
+#ifndef PIPELINED_RECONSTRUCTION_H
+#define PIPELINED_RECONSTRUCTION_H
+
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <thread>
+#include "reconstruction_engine.h"
+#include "bounded_queue.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @struct PipelinedResult
+     * @brief Output of the pipelined Step 2 -> Step 3 execution.
+     */
+    struct PipelinedResult {
+        std::vector<Hexahedron> hexahedra;
+        int faces = 0;            // Faces produced by Step 2.
+        int peakActiveFaces = 0;  // Largest number of faces held by Step 3 at any time.
+    };
+
+    /**
+     * @brief Runs Steps 2 and 3 concurrently, streaming faces through a lock-free queue.
+     *
+     * A producer thread searches faces point by point in order of increasing coordinate along
+     * the longest axis of the cloud, and pushes each face together with a sweep watermark. The
+     * calling thread pairs every incoming face with the faces received before it, exactly as
+     * buildHexahedra does with a face list in that order. Because opposite faces are joined by
+     * graph edges, a face whose far side lies more than the longest edge behind the watermark
+     * can no longer gain a partner and is dropped. A cell can only be found again from faces
+     * inside that band, so its dedup key is dropped on the same horizon, and only the faces and
+     * cell keys of a band around the sweep front are ever held. Face-dedup keys are retired
+     * the same way on the producer side.
+     *
+     * If `faces` is given, every face is also appended to it (which forgoes the memory saving).
+     * If `stop` triggers, both sides stop: the producer at its next point, the calling thread at
+     * its next face, after which it only drains the queue. The result holds the cells found
+     * behind the sweep front up to then. `progress` counts the points whose faces have been
+     * paired, as stage "steps2-3".
+     *
+     * If either side throws (e.g. std::bad_alloc or MemoryCeilingExceeded), the producer stops,
+     * the calling thread drains the queue, the producer is joined and the first exception
+     * (calling thread, then producer) is rethrown.
+     */
+    inline PipelinedResult reconstructPipelined(const std::vector<MeshPoint>& points, const AdjacencyGraph& adjGraph,
+                                                const FaceTolerances& tolerances = FaceTolerances(),
+                                                std::vector<QuadFace>* faces = nullptr, size_t queueCapacity = 4096,
+                                                const StopCondition& stop = StopCondition(), StepStatus* status = nullptr,
+                                                ProgressCounter* progress = nullptr) {
+        reportStatus(status, StepStatus::Completed);
+        beginProgress(progress, "steps2-3", points.size());
+        PipelinedResult result;
+        if (points.empty()) return result;
+
+        // Sweep along the axis with the largest extent.
+        Vector3 minCorner = points[0].pos, maxCorner = points[0].pos;
+        for (const MeshPoint& p : points) {
+            for (int a = 0; a < 3; ++a) {
+                minCorner[a] = std::min(minCorner[a], p.pos[a]);
+                maxCorner[a] = std::max(maxCorner[a], p.pos[a]);
+            }
+        }
+        Vector3 extent = maxCorner - minCorner;
+        int axis = extent.x() >= extent.y() ? (extent.x() >= extent.z() ? 0 : 2) : (extent.y() >= extent.z() ? 1 : 2);
+
+        std::vector<int> order(points.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = (int)i;
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return points[a].pos[axis] < points[b].pos[axis]; });
+        std::vector<int> rank(points.size());
+        for (size_t r = 0; r < order.size(); ++r) rank[order[r]] = (int)r;
+
+        float maxEdge = 0.0f;
+        for (const auto& row : adjGraph) {
+            for (int neighbor : row.second) {
+                maxEdge = std::max(maxEdge, points[row.first].pos.distanceToPoint(points[neighbor].pos));
+            }
+        }
+        // Slack for rounding in the coordinate comparisons.
+        const float reach = maxEdge * 1.001f + 1e-6f;
+
+        // A message with face[0] == -1 only advances the watermark.
+        struct FaceMessage {
+            QuadFace face;
+            float watermark;
+        };
+        SpscBoundedQueue<FaceMessage> queue(queueCapacity);
+
+        StopCheck producerCheck(stop);
+        std::exception_ptr producerError, error;
+        std::atomic<bool> consumerFailed(false);
+        std::thread producer([&]() {
+            try {
+                QSet<QVector<int>> uniqueFaces;
+                std::vector<std::vector<QVector<int>>> retireAt(points.size());
+                std::vector<QuadFace> found;
+                for (size_t r = 0; r < order.size() && !producerCheck.shouldStop(); ++r) {
+                    if (consumerFailed.load(std::memory_order_relaxed)) break;
+                    int p0_idx = order[r];
+                    float watermark = points[p0_idx].pos[axis];
+                    found.clear();
+                    collectFacesFrom(p0_idx, points, adjGraph, uniqueFaces, found, tolerances);
+                    for (const QuadFace& face : found) {
+                        // A face can only be found again from one of its own vertices.
+                        int lastRank = 0;
+                        for (int idx : face) lastRank = std::max(lastRank, rank[idx]);
+                        QVector<int> key = {face[0], face[1], face[2], face[3]};
+                        std::sort(key.begin(), key.end());
+                        retireAt[lastRank].push_back(key);
+
+                        FaceMessage message = {face, watermark};
+                        queue.push(message);
+                    }
+                    for (const QVector<int>& key : retireAt[r]) uniqueFaces.remove(key);
+                    std::vector<QVector<int>>().swap(retireAt[r]);
+
+                    FaceMessage advance = {{{-1, -1, -1, -1}}, watermark};
+                    queue.push(advance);
+                }
+            } catch (...) {
+                producerError = std::current_exception();
+            }
+            // Ends the calling thread's pop loop even if the producer failed.
+            queue.close();
+        });
+
+        struct ActiveFace {
+            QuadFace face;
+            float farSide; // Largest sweep coordinate among the face's vertices.
+        };
+        std::vector<ActiveFace> active;
+        struct ActiveHex {
+            QVector<int> key;
+            float farSide;
+        };
+        std::vector<ActiveHex> activeHexes;
+        QSet<QVector<int>> uniqueHexes;
+        float lastCompaction = -std::numeric_limits<float>::max();
+
+        StopCheck check(stop);
+        FaceMessage message;
+        try {
+            while (queue.pop(message)) {
+                // Once stopped, keep popping so that a producer blocked on a full queue can finish.
+                if (check.shouldStop()) continue;
+                if (message.face[0] < 0) {
+                    // Every face of the point before this marker has been paired.
+                    reportProgress(progress, 0, 1);
+                    if (message.watermark - lastCompaction > 0.5f * reach) {
+                        float horizon = message.watermark - reach;
+                        active.erase(std::remove_if(active.begin(), active.end(), [horizon](const ActiveFace& f) {
+                            return f.farSide < horizon;
+                        }), active.end());
+                        activeHexes.erase(std::remove_if(activeHexes.begin(), activeHexes.end(), [&](const ActiveHex& h) {
+                            if (h.farSide >= horizon) return false;
+                            uniqueHexes.remove(h.key);
+                            return true;
+                        }), activeHexes.end());
+                        lastCompaction = message.watermark;
+                    }
+                    continue;
+                }
+
+                const QuadFace& face = message.face;
+                ++result.faces;
+                if (faces) faces->push_back(face);
+                for (const ActiveFace& earlier : active) {
+                    Hexahedron hex;
+                    if (!pairOppositeFaces(earlier.face, face, adjGraph, hex)) continue;
+                    QVector<int> sortedHex(8);
+                    for (int k = 0; k < 8; ++k) sortedHex[k] = hex[k];
+                    std::sort(sortedHex.begin(), sortedHex.end());
+                    if (uniqueHexes.contains(sortedHex)) continue;
+                    uniqueHexes.insert(sortedHex);
+                    result.hexahedra.push_back(hex);
+
+                    ActiveHex entry = {sortedHex, points[hex[0]].pos[axis]};
+                    for (int idx : hex) entry.farSide = std::max(entry.farSide, points[idx].pos[axis]);
+                    activeHexes.push_back(entry);
+                }
+
+                ActiveFace entry = {face, points[face[0]].pos[axis]};
+                for (int idx : face) entry.farSide = std::max(entry.farSide, points[idx].pos[axis]);
+                active.push_back(entry);
+                result.peakActiveFaces = std::max(result.peakActiveFaces, (int)active.size());
+            }
+        } catch (...) {
+            error = std::current_exception();
+            consumerFailed.store(true, std::memory_order_relaxed);
+            // The producer spins while the queue is full, so keep draining until it closes.
+            while (queue.pop(message)) {}
+        }
+
+        producer.join();
+        if (!error) error = producerError;
+        if (error) std::rethrow_exception(error);
+        reportStatus(status, check.status() != StepStatus::Completed ? check.status() : producerCheck.status());
+        return result;
+    }
+} // namespace ReconstructionEngine
+
+#endif // PIPELINED_RECONSTRUCTION_H
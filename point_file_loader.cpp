@@ -0,0 +1,75 @@
+#include "point_file_loader.h"
+#include "point_io.h"
+
+namespace {
+    const size_t kPreviewPoints = 20000;
+}
+
+PointFileLoader::PointFileLoader(QObject *parent)
+    : QObject(parent), m_cancel(false), m_succeeded(false) {
+    // Joining from the receiving side keeps the thread handle owned by the GUI thread.
+    connect(this, &PointFileLoader::finished, this, &PointFileLoader::joinWorker, Qt::QueuedConnection);
+}
+
+PointFileLoader::~PointFileLoader() {
+    cancel();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+bool PointFileLoader::start(const QString &path) {
+    if (m_thread.joinable()) return false;
+    m_path = path;
+    m_cancel = false;
+    m_preview.clear();
+    m_points.clear();
+    m_succeeded = false;
+    m_error.clear();
+    m_exception = nullptr;
+    m_thread = std::thread(&PointFileLoader::run, this);
+    return true;
+}
+
+void PointFileLoader::cancel() { m_cancel = true; }
+
+std::vector<MeshPoint> PointFileLoader::takePreview() { return std::move(m_preview); }
+std::vector<MeshPoint> PointFileLoader::takePoints() { return std::move(m_points); }
+
+QString PointFileLoader::errorString() const {
+    if (!m_exception) return m_error;
+    try {
+        std::rethrow_exception(m_exception);
+    } catch (const std::exception &error) {
+        return QString("Cannot load %1: %2").arg(m_path, QString::fromLocal8Bit(error.what()));
+    } catch (...) {
+        return QString("Cannot load %1").arg(m_path);
+    }
+}
+
+void PointFileLoader::joinWorker() {
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void PointFileLoader::run() {
+    // Nothing may escape the thread: an exception (e.g. std::bad_alloc for a file too large to
+    // hold) is kept for errorString(), and finished is still emitted so that the worker is joined.
+    try {
+        // A preview failure is not fatal; the full load reports the real problem.
+        if (ReconstructionEngine::loadPointPreview(m_path, kPreviewPoints, m_preview) && !m_preview.empty()) emit previewReady();
+
+        int lastPermille = -1;
+        ReconstructionEngine::LoadProgress progress = [this, &lastPermille](qint64 done, qint64 total) {
+            int permille = total > 0 ? (int)(1000 * done / total) : 1000;
+            if (permille != lastPermille) {
+                lastPermille = permille;
+                emit progressChanged(permille);
+            }
+            return !m_cancel.load();
+        };
+        m_succeeded = ReconstructionEngine::loadPointFile(m_path, m_points, &m_error, ReconstructionEngine::IoBackend::Synchronous, progress);
+    } catch (...) {
+        m_succeeded = false;
+        std::vector<MeshPoint>().swap(m_points);
+        m_exception = std::current_exception();
+    }
+    emit finished();
+}
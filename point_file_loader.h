@@ -0,0 +1,66 @@
+#ifndef POINT_FILE_LOADER_H
+#define POINT_FILE_LOADER_H
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+#include "reconstruction_engine.h"
+
+/**
+ * @class PointFileLoader
+ * @brief Loads a point file on a background thread for the GUI.
+ *
+ * A load first reads a small sample spread over the file (previewReady), then the whole file
+ * (progressChanged as it goes, finished at the end). Signals are emitted from the worker
+ * thread, so connect them with Qt::QueuedConnection or rely on the automatic connection type
+ * of receivers living in the GUI thread. The results may be taken once the matching signal
+ * has been delivered.
+ */
+class PointFileLoader : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PointFileLoader(QObject *parent = nullptr);
+    ~PointFileLoader() override;
+
+    // Starts loading `path`; returns false if a load is already running.
+    bool start(const QString &path);
+    // Asks the running load to stop; it then finishes with wasCancelled() true.
+    void cancel();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    const QString &path() const { return m_path; }
+    std::vector<MeshPoint> takePreview();
+
+    // Valid after finished(): the loaded points, or why there are none (including an exception
+    // such as std::bad_alloc thrown while loading).
+    bool succeeded() const { return m_succeeded; }
+    bool wasCancelled() const { return m_succeeded || m_exception ? false : m_cancel.load(); }
+    QString errorString() const;
+    std::vector<MeshPoint> takePoints();
+
+signals:
+    void previewReady();
+    void progressChanged(int permille);
+    void finished();
+
+private slots:
+    void joinWorker();
+
+private:
+    void run();
+
+    QString m_path;
+    std::thread m_thread;
+    std::atomic<bool> m_cancel;
+    std::vector<MeshPoint> m_preview;
+    std::vector<MeshPoint> m_points;
+    bool m_succeeded;
+    QString m_error;
+    std::exception_ptr m_exception;
+};
+
+#endif // POINT_FILE_LOADER_H
@@ -0,0 +1,55 @@
+#ifndef POINT_GENERATORS_H
+#define POINT_GENERATORS_H
+
+#include <cstdint>
+#include <vector>
+#include "reconstruction_engine.h"
+
+namespace ReconstructionEngine {
+    // How generateGridPoints perturbs the lattice.
+    enum class GridJitter {
+        PerLine,  // One x offset per x index and one y offset per y index: faces stay planar.
+        PerPoint  // Every point moves on its own: most vertical faces fail the coplanarity test.
+    };
+
+    /**
+     * @brief Generates the corner points of an nx x ny x nz lattice of points, i.e. a block of
+     * (nx-1) x (ny-1) x (nz-1) hexahedra, with exact neighbor constraints.
+     *
+     * Points are numbered x fastest, then y, then z. Each point requires as many neighbors as
+     * it has axis-aligned lattice neighbors. `jitter` displaces x and y by up to +-jitter/2
+     * (deterministically from `seed`) while keeping every z-layer planar; keep it well below
+     * half the spacing so the kNN constraints stay unambiguous. With the default per-line
+     * jitter the spacing varies but every face is planar, so Steps 2 and 3 see a complete mesh;
+     * per-point jitter tilts the vertical faces by far more than the default 1e-3 tolerance.
+     */
+    inline std::vector<MeshPoint> generateGridPoints(int nx, int ny, int nz, float spacing = 1.0f, float jitter = 0.0f,
+                                                     uint32_t seed = 1, GridJitter mode = GridJitter::PerLine) {
+        std::vector<MeshPoint> points;
+        if (nx <= 0 || ny <= 0 || nz <= 0) return points;
+        points.reserve((size_t)nx * ny * nz);
+        uint32_t state = seed;
+        auto offset = [&]() {
+            state = state * 1664525u + 1013904223u;
+            return ((state >> 8) / float(1 << 24) - 0.5f) * jitter;
+        };
+        std::vector<float> xOffsets(nx), yOffsets(ny);
+        if (mode == GridJitter::PerLine) {
+            for (float& o : xOffsets) o = offset();
+            for (float& o : yOffsets) o = offset();
+        }
+        for (int z = 0; z < nz; ++z) {
+            for (int y = 0; y < ny; ++y) {
+                for (int x = 0; x < nx; ++x) {
+                    int neighbors = (x > 0) + (x < nx - 1) + (y > 0) + (y < ny - 1) + (z > 0) + (z < nz - 1);
+                    float px = x * spacing + (mode == GridJitter::PerPoint ? offset() : xOffsets[x]);
+                    float py = y * spacing + (mode == GridJitter::PerPoint ? offset() : yOffsets[y]);
+                    points.push_back({Vector3(px, py, z * spacing), neighbors});
+                }
+            }
+        }
+        return points;
+    }
+} // namespace ReconstructionEngine
+
+#endif // POINT_GENERATORS_H
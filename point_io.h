@@ -0,0 +1,206 @@
+#ifndef POINT_IO_H
+#define POINT_IO_H
+
+#include <cstdlib>
+#include <functional>
+#include <QFile>
+#include <QString>
+#include "reconstruction_engine.h"
+#include "bulk_io.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @brief Reports the progress of a load: bytes processed and the file size. Returning
+     * false cancels the load.
+     */
+    using LoadProgress = std::function<bool(qint64 done, qint64 total)>;
+
+    const int kProgressInterval = 16384;  // Records between two progress reports.
+
+    enum class PointRecord { Skipped, Parsed, Invalid };
+
+    // Parses one line of a text point file.
+    inline PointRecord parsePointRecord(const char* line, MeshPoint& point) {
+        const char* cursor = line;
+        while (*cursor == ' ' || *cursor == '\t') ++cursor;
+        if (*cursor == '\0' || *cursor == '\n' || *cursor == '\r' || *cursor == '#') return PointRecord::Skipped;
+
+        char* end = nullptr;
+        float coords[3];
+        for (int a = 0; a < 3; ++a) {
+            coords[a] = std::strtof(cursor, &end);
+            if (end == cursor) return PointRecord::Invalid;
+            cursor = end;
+        }
+        long neighbors = std::strtol(cursor, &end, 10);
+        if (end == cursor || neighbors < 0) return PointRecord::Invalid;
+        point = {Vector3(coords[0], coords[1], coords[2]), (int)neighbors};
+        return PointRecord::Parsed;
+    }
+
+    /**
+     * @brief Loads points from a text file with one "x y z required_neighbors" record per line.
+     *
+     * Blank lines and lines starting with '#' are skipped. On failure or cancellation `points`
+     * is left empty and, if given, `errorMessage` describes the problem.
+     */
+    inline bool loadPoints(const QString& path, std::vector<MeshPoint>& points, QString* errorMessage = nullptr,
+                           const LoadProgress& progress = LoadProgress()) {
+        points.clear();
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            if (errorMessage) *errorMessage = QString("Cannot open %1: %2").arg(path, file.errorString());
+            return false;
+        }
+
+        const qint64 total = file.size();
+        char line[1024];
+        int lineNumber = 0;
+        while (file.readLine(line, sizeof(line)) > 0) {
+            ++lineNumber;
+            if (progress && lineNumber % kProgressInterval == 0 && !progress(file.pos(), total)) {
+                points.clear();
+                if (errorMessage) *errorMessage = QString("Loading %1 was cancelled").arg(path);
+                return false;
+            }
+            MeshPoint point;
+            PointRecord record = parsePointRecord(line, point);
+            if (record == PointRecord::Skipped) continue;
+            if (record == PointRecord::Invalid) {
+                points.clear();
+                if (errorMessage) *errorMessage = QString("%1:%2: expected \"x y z required_neighbors\"").arg(path).arg(lineNumber);
+                return false;
+            }
+            points.push_back(point);
+        }
+        if (progress) progress(total, total);
+        return true;
+    }
+
+    /**
+     * @brief Loads points from the binary point format (.hxp).
+     *
+     * Layout (little-endian): the magic "HXP1", a uint64 point count, then per point three
+     * float32 coordinates and an int32 required_neighbors. The file is read in one bulk
+     * transfer through `backend`.
+     */
+    inline bool loadPointsBinary(const QString& path, std::vector<MeshPoint>& points, QString* errorMessage = nullptr,
+                                 IoBackend backend = IoBackend::Synchronous, const LoadProgress& progress = LoadProgress()) {
+        points.clear();
+        IoBuffer buffer;
+        if (!readFileBulk(path, buffer, backend, errorMessage)) return false;
+
+        const size_t kHeaderSize = 12, kRecordSize = 16;
+        uint64_t count = 0;
+        if (buffer.size() >= kHeaderSize) count = loadLittleEndian<uint64_t>(buffer.data() + 4);
+        if (buffer.size() < kHeaderSize || std::memcmp(buffer.data(), "HXP1", 4) != 0 ||
+            count != (buffer.size() - kHeaderSize) / kRecordSize || (buffer.size() - kHeaderSize) % kRecordSize != 0) {
+            if (errorMessage) *errorMessage = QString("%1: not a binary point file").arg(path);
+            return false;
+        }
+
+        // The transfer itself is not interruptible; progress covers the decoding.
+        points.resize((size_t)count);
+        const char* record = buffer.data() + kHeaderSize;
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (progress && i % kProgressInterval == 0 && !progress((qint64)(kHeaderSize + i * kRecordSize), (qint64)buffer.size())) {
+                points.clear();
+                if (errorMessage) *errorMessage = QString("Loading %1 was cancelled").arg(path);
+                return false;
+            }
+            MeshPoint& p = points[i];
+            p.pos = Vector3(loadLittleEndian<float>(record), loadLittleEndian<float>(record + 4), loadLittleEndian<float>(record + 8));
+            p.required_neighbors = loadLittleEndian<int32_t>(record + 12);
+            record += kRecordSize;
+        }
+        if (progress) progress((qint64)buffer.size(), (qint64)buffer.size());
+        return true;
+    }
+
+    /**
+     * @brief Saves points in the binary point format read by loadPointsBinary.
+     */
+    inline bool savePointsBinary(const QString& path, const std::vector<MeshPoint>& points, QString* errorMessage = nullptr,
+                                 IoBackend backend = IoBackend::Synchronous) {
+        IoBuffer buffer;
+        buffer.resize(12 + points.size() * 16);
+        uint64_t count = points.size();
+        std::memcpy(buffer.data(), "HXP1", 4);
+        storeLittleEndian(buffer.data() + 4, count);
+        char* record = buffer.data() + 12;
+        for (const MeshPoint& p : points) {
+            storeLittleEndian(record, p.pos.x());
+            storeLittleEndian(record + 4, p.pos.y());
+            storeLittleEndian(record + 8, p.pos.z());
+            storeLittleEndian(record + 12, (int32_t)p.required_neighbors);
+            record += 16;
+        }
+        return writeFileBulk(path, buffer.data(), buffer.size(), backend, errorMessage);
+    }
+
+    /**
+     * @brief Loads a point file in either format: binary for the .hxp suffix, text otherwise.
+     */
+    inline bool loadPointFile(const QString& path, std::vector<MeshPoint>& points, QString* errorMessage = nullptr,
+                              IoBackend backend = IoBackend::Synchronous, const LoadProgress& progress = LoadProgress()) {
+        if (path.endsWith(".hxp", Qt::CaseInsensitive)) return loadPointsBinary(path, points, errorMessage, backend, progress);
+        return loadPoints(path, points, errorMessage, progress);
+    }
+
+    /**
+     * @brief Reads about `maxPoints` points spread evenly over a point file of either format,
+     * without reading the rest of it, for a quick preview of a large file.
+     *
+     * Binary files are sampled at a fixed record stride. Text files are sampled by seeking to
+     * evenly spaced byte offsets and taking the first record after each, so the sample follows
+     * the file order but not exactly the record count. Malformed text lines are skipped; the
+     * full load reports them.
+     */
+    inline bool loadPointPreview(const QString& path, size_t maxPoints, std::vector<MeshPoint>& points, QString* errorMessage = nullptr) {
+        points.clear();
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            if (errorMessage) *errorMessage = QString("Cannot open %1: %2").arg(path, file.errorString());
+            return false;
+        }
+        const qint64 size = file.size();
+        if (maxPoints == 0 || size == 0) return true;
+
+        if (path.endsWith(".hxp", Qt::CaseInsensitive)) {
+            const qint64 kHeaderSize = 12, kRecordSize = 16;
+            char header[12];
+            uint64_t count = 0;
+            if (file.read(header, kHeaderSize) == kHeaderSize) count = loadLittleEndian<uint64_t>(header + 4);
+            if (size < kHeaderSize || std::memcmp(header, "HXP1", 4) != 0 || count != (uint64_t)(size - kHeaderSize) / kRecordSize) {
+                if (errorMessage) *errorMessage = QString("%1: not a binary point file").arg(path);
+                return false;
+            }
+            uint64_t stride = std::max<uint64_t>(1, (count + maxPoints - 1) / maxPoints);
+            for (uint64_t i = 0; i < count; i += stride) {
+                char record[16];
+                if (!file.seek(kHeaderSize + (qint64)i * kRecordSize) || file.read(record, kRecordSize) != kRecordSize) break;
+                points.push_back({Vector3(loadLittleEndian<float>(record), loadLittleEndian<float>(record + 4),
+                                          loadLittleEndian<float>(record + 8)), loadLittleEndian<int32_t>(record + 12)});
+            }
+            return true;
+        }
+
+        char line[1024];
+        qint64 resume = 0; // Where the line after the last sampled record starts.
+        for (size_t k = 0; k < maxPoints; ++k) {
+            qint64 offset = std::max(resume, (qint64)((double)size * k / maxPoints));
+            if (offset >= size || !file.seek(offset)) break;
+            // Unless at the start of a line, skip the rest of the one the offset falls into.
+            if (offset != resume && file.readLine(line, sizeof(line)) <= 0) break;
+            MeshPoint point;
+            PointRecord record = PointRecord::Skipped;
+            while (record != PointRecord::Parsed && file.readLine(line, sizeof(line)) > 0) record = parsePointRecord(line, point);
+            if (record != PointRecord::Parsed) break;
+            points.push_back(point);
+            resume = file.pos();
+        }
+        return true;
+    }
+} // namespace ReconstructionEngine
+
+#endif // POINT_IO_H
@@ -0,0 +1,126 @@
+#ifndef PREVIEW_RECONSTRUCTION_H
+#define PREVIEW_RECONSTRUCTION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "reconstruction_engine.h"
+#include "parallel.h"
+#include "region_reconstruction.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @struct PreviewOptions
+     * @brief Sampling parameters of a preview reconstruction. Lengths are in multiples of the
+     * estimated point spacing, so the defaults suit any scale.
+     */
+    struct PreviewOptions {
+        int patchesPerAxis = 2;      // Strata per axis; one patch is reconstructed in each.
+        float patchSpacings = 3.0f;  // Edge length of a patch's core box.
+        // Margin of context points around the core box. Narrower than kDefaultHaloSpacings for
+        // speed, at the risk of missing a cell at the very edge of a core now and then.
+        float haloSpacings = 1.5f;
+        FaceTolerances tolerances;
+    };
+
+    /**
+     * @struct PreviewResult
+     * @brief Output of a preview reconstruction. Graph rows, faces and cells refer to the
+     * indices of the full point set, so they can be drawn over it.
+     */
+    struct PreviewResult {
+        AdjacencyGraph adjGraph;               // Rows of the core points only.
+        std::vector<QuadFace> faces;
+        std::vector<Hexahedron> hexahedra;
+        int patches = 0;
+        int corePoints = 0;
+        int reconstructedPoints = 0;           // Core and halo points, i.e. the work done.
+        double estimatedHexahedra = 0.0;       // The cell count extrapolated to the full point set.
+        double seconds = 0.0;
+    };
+
+    /**
+     * @brief Splits the bounding box of the cloud into up to patchesPerAxis^3 strata and
+     * returns one core box centered in each. Axes too short for several patches, including
+     * flat ones, get a single stratum whose core spans the whole extent if it fits.
+     */
+    inline std::vector<RegionOfInterest> stratifiedPatches(const std::vector<MeshPoint>& points, float spacing,
+                                                           const PreviewOptions& options = PreviewOptions()) {
+        std::vector<RegionOfInterest> patches;
+        if (points.empty()) return patches;
+        Vector3 lo = points[0].pos, hi = points[0].pos;
+        for (const MeshPoint& p : points) {
+            for (int a = 0; a < 3; ++a) {
+                lo[a] = std::min(lo[a], p.pos[a]);
+                hi[a] = std::max(hi[a], p.pos[a]);
+            }
+        }
+
+        const float patchSize = options.patchSpacings * spacing;
+        int strata[3];
+        for (int a = 0; a < 3; ++a) {
+            strata[a] = std::max(1, std::min(options.patchesPerAxis, (int)((hi[a] - lo[a]) / patchSize)));
+            // Boxes are half-open; this keeps the points on the upper faces inside the last stratum.
+            hi[a] += 1e-3f * spacing;
+        }
+        for (int z = 0; z < strata[2]; ++z) {
+            for (int y = 0; y < strata[1]; ++y) {
+                for (int x = 0; x < strata[0]; ++x) {
+                    const int cell[3] = {x, y, z};
+                    Vector3 minCorner, maxCorner;
+                    for (int a = 0; a < 3; ++a) {
+                        float stratum = (hi[a] - lo[a]) / strata[a];
+                        float center = lo[a] + (cell[a] + 0.5f) * stratum;
+                        // Cores never overlap, so no cell is found by two patches.
+                        float half = 0.5f * std::min(patchSize, stratum);
+                        minCorner[a] = center - half;
+                        maxCorner[a] = center + half;
+                    }
+                    patches.push_back(RegionOfInterest::box(minCorner, maxCorner));
+                }
+            }
+        }
+        return patches;
+    }
+
+    /**
+     * @brief Quick look at what a full reconstruction will produce: reconstructs small
+     * patches spread evenly over the cloud, in parallel.
+     *
+     * Each patch costs O(m^2) in its own point count m rather than the O(N^2) of the full
+     * Step 1, so with the default options a preview takes well under a second for any input
+     * size. Every cell has eight corners, so a full reconstruction yields N * c / 8 cells when
+     * its N points lie in c cells on average; the estimate takes c from the core points.
+     */
+    inline PreviewResult reconstructPreview(const std::vector<MeshPoint>& points, const PreviewOptions& options = PreviewOptions()) {
+        auto start = std::chrono::steady_clock::now();
+        PreviewResult result;
+        if (points.empty()) return result;
+
+        UniformGridIndex index(points);
+        float spacing = index.cellSize();
+        std::vector<RegionOfInterest> patches = stratifiedPatches(points, spacing, options);
+        std::vector<RegionResult> partial(patches.size());
+        parallelFor(0, (int)patches.size(), [&](int i) {
+            partial[i] = reconstructRegion(points, index, patches[i], options.haloSpacings * spacing, options.tolerances);
+        }, 1);
+
+        int64_t coreIncidences = 0;
+        for (RegionResult& part : partial) {
+            for (auto& row : part.adjGraph) result.adjGraph[row.first] = std::move(row.second);
+            result.faces.insert(result.faces.end(), part.faces.begin(), part.faces.end());
+            result.hexahedra.insert(result.hexahedra.end(), part.hexahedra.begin(), part.hexahedra.end());
+            result.corePoints += part.corePoints;
+            result.reconstructedPoints += (int)part.pointIndices.size();
+            coreIncidences += part.coreIncidences;
+        }
+        result.patches = (int)patches.size();
+        if (result.corePoints > 0) result.estimatedHexahedra = (double)points.size() * coreIncidences / (8.0 * result.corePoints);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+} // namespace ReconstructionEngine
+
+#endif // PREVIEW_RECONSTRUCTION_H
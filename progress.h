@@ -0,0 +1,168 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "parallel.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @struct ProgressSample
+     * @brief A snapshot of a ProgressCounter.
+     */
+    struct ProgressSample {
+        const char* stage = nullptr;  // Null before the first step begins.
+        uint64_t done = 0;
+        uint64_t total = 0;
+        double seconds = 0.0;         // Since the stage began.
+
+        double fraction() const { return total ? std::min(1.0, (double)done / total) : 0.0; }
+
+        // Remaining time at the average rate so far, or -1 while there is too little to go on.
+        double etaSeconds() const {
+            double f = fraction();
+            return f > 0.0 && seconds > 0.0 ? seconds * (1.0 - f) / f : -1.0;
+        }
+    };
+
+    /**
+     * @class ProgressCounter
+     * @brief Work-item counters that the steps bump from their outer loops.
+     *
+     * Each worker adds to its own slot on its own cache line, so counting never contends and
+     * costs one uncontended relaxed add per outer iteration. Readers sum the slots; a sample
+     * may be a few items behind but never needs a lock. A step calls begin() before its loop,
+     * which resets the counts, so one counter can follow Steps 1-3 in turn.
+     */
+    class ProgressCounter {
+    public:
+        // `slotCount` defaults to one per engine worker plus one for a pipeline's second thread.
+        explicit ProgressCounter(int slotCount = 0)
+            : m_count(slotCount > 0 ? slotCount : threadCount() + 1), m_slots(new Slot[m_count]),
+              m_stage(nullptr), m_total(0), m_start(0) {
+            for (int i = 0; i < m_count; ++i) m_slots[i].value.store(0, std::memory_order_relaxed);
+        }
+
+        // Starts counting `total` items of `stage` (a string literal). Call between steps only.
+        void begin(const char* stage, uint64_t total) {
+            for (int i = 0; i < m_count; ++i) m_slots[i].value.store(0, std::memory_order_relaxed);
+            m_total.store(total, std::memory_order_relaxed);
+            m_start.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+            m_stage.store(stage, std::memory_order_release);
+        }
+
+        // Workers beyond the slot count share slots, which stays correct, only slower.
+        void add(int worker, uint64_t items) { m_slots[worker % m_count].value.fetch_add(items, std::memory_order_relaxed); }
+
+        ProgressSample sample() const {
+            ProgressSample s;
+            s.stage = m_stage.load(std::memory_order_acquire);
+            s.total = m_total.load(std::memory_order_relaxed);
+            for (int i = 0; i < m_count; ++i) s.done += m_slots[i].value.load(std::memory_order_relaxed);
+            Clock::duration elapsed = Clock::now().time_since_epoch() - Clock::duration(m_start.load(std::memory_order_relaxed));
+            s.seconds = s.stage ? std::chrono::duration<double>(elapsed).count() : 0.0;
+            return s;
+        }
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        // Padded rather than aligned, since new[] ignores over-alignment before C++17; the
+        // counters still lie a cache line apart.
+        struct Slot {
+            std::atomic<uint64_t> value;
+            char padding[64 - sizeof(std::atomic<uint64_t>)];
+        };
+
+        ProgressCounter(const ProgressCounter&) = delete;
+        ProgressCounter& operator=(const ProgressCounter&) = delete;
+
+        int m_count;
+        std::unique_ptr<Slot[]> m_slots;
+        std::atomic<const char*> m_stage;
+        std::atomic<uint64_t> m_total;
+        std::atomic<Clock::rep> m_start;
+    };
+
+    // Helpers for the optional progress parameter of the steps.
+    inline void beginProgress(ProgressCounter* progress, const char* stage, uint64_t total) {
+        if (progress) progress->begin(stage, total);
+    }
+
+    inline void reportProgress(ProgressCounter* progress, int worker, uint64_t items) {
+        if (progress) progress->add(worker, items);
+    }
+
+    /**
+     * @class ProgressMonitor
+     * @brief Samples a ProgressCounter on its own thread at a fixed interval and passes each
+     * sample to a callback, so the workers never call out themselves.
+     *
+     * The callback runs on the monitor thread; a GUI should forward the sample through a
+     * queued signal. If it throws, sampling stops. stop() (or the destructor) delivers one
+     * last sample and joins.
+     */
+    class ProgressMonitor {
+    public:
+        typedef std::function<void(const ProgressSample&)> Callback;
+
+        ProgressMonitor(const ProgressCounter& counter, Callback callback, int intervalMs = 100)
+            : m_counter(counter), m_callback(std::move(callback)), m_interval(std::max(intervalMs, 1)), m_stopping(false) {
+            m_thread = std::thread([this]() { run(); });
+        }
+
+        ~ProgressMonitor() { stop(); }
+
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_wake.notify_one();
+            if (m_thread.joinable()) m_thread.join();
+        }
+
+    private:
+        ProgressMonitor(const ProgressMonitor&) = delete;
+        ProgressMonitor& operator=(const ProgressMonitor&) = delete;
+
+        void run() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_wake.wait_for(lock, m_interval, [this]() { return m_stopping; })) {
+                lock.unlock();
+                if (!report()) return;
+                lock.lock();
+            }
+            lock.unlock();
+            report();
+        }
+
+        // An exception would end the process on this thread (e.g. a memory ceiling hit while
+        // formatting), so a throwing callback just ends the sampling.
+        bool report() {
+            try {
+                m_callback(m_counter.sample());
+                return true;
+            } catch (...) {
+                return false;
+            }
+        }
+
+        const ProgressCounter& m_counter;
+        Callback m_callback;
+        std::chrono::milliseconds m_interval;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        bool m_stopping;
+        std::thread m_thread;
+    };
+} // namespace ReconstructionEngine
+
+#endif // PROGRESS_H
@@ -0,0 +1,207 @@
+#ifndef QUANTIZED_POINTS_H
+#define QUANTIZED_POINTS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "reconstruction_engine.h"
+#include "parallel.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @class QuantizedPointCloud
+     * @brief Point positions stored as 16- or 21-bit integers per axis relative to the cloud's
+     * bounding-box origin, with one step size shared by all axes.
+     *
+     * 16-bit clouds keep three uint16 arrays (6 bytes per position), 21-bit clouds pack the
+     * three axes into one uint64 (8 bytes), against 12 bytes for float positions. 16-bit clouds
+     * use 15 of the bits, so that a squared distance (at most 3 * 32767^2) fits a uint32 and
+     * the Step 1 distance loop runs in 32-bit lanes like float positions, on 16-bit loads that
+     * take half the memory traffic. Because the
+     * step is isotropic, integer squared distances order neighbors the same way as the
+     * dequantized positions, so Step 1 can run on integers alone. The quantization error per
+     * axis is at most half a step; to quantize per tile, build one cloud per tile.
+     */
+    class QuantizedPointCloud {
+    public:
+        QuantizedPointCloud() : m_bits(16), m_step(1.0f), m_count(0) {}
+
+        explicit QuantizedPointCloud(const std::vector<MeshPoint>& points, int bits = 16)
+            : m_bits(bits > 16 ? 21 : 16), m_step(1.0f), m_count(points.size()) {
+            if (points.empty()) return;
+            Vector3 maxCorner = points[0].pos;
+            m_origin = points[0].pos;
+            for (const MeshPoint& p : points) {
+                for (int a = 0; a < 3; ++a) {
+                    m_origin[a] = std::min(m_origin[a], p.pos[a]);
+                    maxCorner[a] = std::max(maxCorner[a], p.pos[a]);
+                }
+            }
+            Vector3 extent = maxCorner - m_origin;
+            float largest = std::max({extent.x(), extent.y(), extent.z()});
+            const uint32_t maxLevel = (1u << levelBits()) - 1;
+            if (largest > 0.0f) m_step = largest / maxLevel;
+
+            if (m_bits == 16) {
+                for (int a = 0; a < 3; ++a) m_axes[a].resize(m_count);
+            } else {
+                m_packed.resize(m_count);
+            }
+            m_requiredNeighbors.resize(m_count);
+            for (size_t i = 0; i < m_count; ++i) {
+                uint32_t q[3];
+                for (int a = 0; a < 3; ++a) {
+                    float level = std::round((points[i].pos[a] - m_origin[a]) / m_step);
+                    q[a] = (uint32_t)std::min<float>(std::max(level, 0.0f), (float)maxLevel);
+                }
+                if (m_bits == 16) {
+                    for (int a = 0; a < 3; ++a) m_axes[a][i] = (uint16_t)q[a];
+                } else {
+                    m_packed[i] = (uint64_t)q[0] | ((uint64_t)q[1] << 21) | ((uint64_t)q[2] << 42);
+                }
+                m_requiredNeighbors[i] = (uint16_t)std::min(std::max(points[i].required_neighbors, 0), 0xffff);
+            }
+        }
+
+        int bits() const { return m_bits; }
+        // Bits of each quantized coordinate actually used: 15 in 16-bit clouds.
+        int levelBits() const { return m_bits == 16 ? 15 : 21; }
+        size_t size() const { return m_count; }
+        const Vector3& origin() const { return m_origin; }
+        float step() const { return m_step; }
+
+        // Largest displacement caused by quantization (float rounding of positions comes on top).
+        float maxError() const { return 0.5f * m_step * std::sqrt(3.0f); }
+
+        // Bytes held for positions and neighbor constraints.
+        size_t memoryBytes() const {
+            return (m_axes[0].size() + m_axes[1].size() + m_axes[2].size() + m_requiredNeighbors.size()) * sizeof(uint16_t) +
+                   m_packed.size() * sizeof(uint64_t);
+        }
+
+        uint32_t coordinate(int i, int axis) const {
+            if (m_bits == 16) return m_axes[axis][i];
+            return (uint32_t)(m_packed[i] >> (21 * axis)) & 0x1fffff;
+        }
+
+        int requiredNeighbors(int i) const { return m_requiredNeighbors[i]; }
+
+        Vector3 position(int i) const {
+            return m_origin + Vector3(coordinate(i, 0) * m_step, coordinate(i, 1) * m_step, coordinate(i, 2) * m_step);
+        }
+
+        // Squared distance in quantization steps.
+        uint64_t distanceSquared(int a, int b) const {
+            if (m_bits == 16) {
+                uint32_t sum = 0;
+                for (int axis = 0; axis < 3; ++axis) {
+                    int32_t d = (int32_t)m_axes[axis][a] - (int32_t)m_axes[axis][b];
+                    sum += (uint32_t)(d * d);
+                }
+                return sum;
+            }
+            uint64_t sum = 0;
+            for (int axis = 0; axis < 3; ++axis) {
+                int64_t d = (int64_t)coordinate(a, axis) - (int64_t)coordinate(b, axis);
+                sum += (uint64_t)(d * d);
+            }
+            return sum;
+        }
+
+        /**
+         * @brief Fills `out[j]` with the squared integer distance from point `i` to every point j
+         * of a 16-bit cloud.
+         *
+         * The loop runs over contiguous uint16 arrays without branches and computes in int32
+         * and uint32, so the compiler vectorizes it with 32-bit lanes and the output is as
+         * large as a float distance array.
+         */
+        void distancesFrom(int i, std::vector<uint32_t>& out) const {
+            out.resize(m_count);
+            uint32_t* dst = out.data();
+            const uint16_t* xs = m_axes[0].data();
+            const uint16_t* ys = m_axes[1].data();
+            const uint16_t* zs = m_axes[2].data();
+            const int32_t x = xs[i], y = ys[i], z = zs[i];
+            for (size_t j = 0; j < m_count; ++j) {
+                int32_t dx = xs[j] - x, dy = ys[j] - y, dz = zs[j] - z;
+                // Each square is below 2^30 with 15-bit levels, and their sum below 2^32.
+                dst[j] = (uint32_t)(dx * dx) + (uint32_t)(dy * dy) + (uint32_t)(dz * dz);
+            }
+        }
+
+        /**
+         * @brief The same for a 21-bit cloud, whose squared distances need 64 bits.
+         */
+        void distancesFrom(int i, std::vector<uint64_t>& out) const {
+            out.resize(m_count);
+            uint64_t* dst = out.data();
+            const uint64_t* packed = m_packed.data();
+            const int64_t x = packed[i] & 0x1fffff, y = (packed[i] >> 21) & 0x1fffff, z = packed[i] >> 42;
+            for (size_t j = 0; j < m_count; ++j) {
+                int64_t dx = (int64_t)(packed[j] & 0x1fffff) - x;
+                int64_t dy = (int64_t)((packed[j] >> 21) & 0x1fffff) - y;
+                int64_t dz = (int64_t)(packed[j] >> 42) - z;
+                dst[j] = (uint64_t)(dx * dx + dy * dy + dz * dz);
+            }
+        }
+
+        /**
+         * @brief Returns the dequantized points, for the geometric tests of Steps 2 and 3.
+         */
+        std::vector<MeshPoint> dequantize() const {
+            std::vector<MeshPoint> points(m_count);
+            for (size_t i = 0; i < m_count; ++i) points[i] = {position((int)i), m_requiredNeighbors[i]};
+            return points;
+        }
+
+    private:
+        int m_bits;
+        Vector3 m_origin;
+        float m_step;
+        size_t m_count;
+        std::vector<uint16_t> m_axes[3];           // 16-bit clouds, one array per axis.
+        std::vector<uint64_t> m_packed;            // 21-bit clouds: x | y << 21 | z << 42.
+        std::vector<uint16_t> m_requiredNeighbors;
+    };
+
+    // Step 1 with `Distance` matching the cloud: uint32_t for 16-bit clouds, uint64_t for 21-bit.
+    template <typename Distance>
+    inline AdjacencyGraph buildQuantizedAdjacencyGraph(const QuantizedPointCloud& cloud) {
+        const int count = (int)cloud.size();
+        std::vector<std::vector<int>> rows(count);
+        parallelForChunks(0, count, [&](int chunkBegin, int chunkEnd, int) {
+            std::vector<Distance> distances;
+            std::vector<std::pair<Distance, int>> candidates;
+            for (int i = chunkBegin; i < chunkEnd; ++i) {
+                cloud.distancesFrom(i, distances);
+                candidates.clear();
+                for (int j = 0; j < count; ++j) {
+                    if (j != i) candidates.push_back({distances[j], j});
+                }
+                int k = std::min(cloud.requiredNeighbors(i), (int)candidates.size());
+                std::nth_element(candidates.begin(), candidates.begin() + k, candidates.end());
+                std::sort(candidates.begin(), candidates.begin() + k);
+                for (int n = 0; n < k; ++n) rows[i].push_back(candidates[n].second);
+            }
+        }, 16);
+
+        AdjacencyGraph adjGraph;
+        for (int i = 0; i < count; ++i) adjGraph[i] = std::unordered_set<int>(rows[i].begin(), rows[i].end());
+        return adjGraph;
+    }
+
+    /**
+     * @brief Step 1 on a quantized cloud, using integer distances only.
+     *
+     * Ties are broken by index, as in buildAdjacencyGraph. Against Step 1 on the original
+     * float points, a row can only differ where two candidates lie within about two
+     * quantization errors of the same distance.
+     */
+    inline AdjacencyGraph buildAdjacencyGraph(const QuantizedPointCloud& cloud) {
+        if (cloud.bits() == 16) return buildQuantizedAdjacencyGraph<uint32_t>(cloud);
+        return buildQuantizedAdjacencyGraph<uint64_t>(cloud);
+    }
+} // namespace ReconstructionEngine
+
+#endif // QUANTIZED_POINTS_H
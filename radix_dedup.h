@@ -0,0 +1,184 @@
+#ifndef RADIX_DEDUP_H
+#define RADIX_DEDUP_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "reconstruction_engine.h"
+#include "parallel.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @struct CanonicalKey
+     * @brief The sorted vertex indices of a face (Words = 2) or hexahedron (Words = 4) packed
+     * into a 128- or 256-bit integer, most significant word first, two indices per word.
+     */
+    template <int Words>
+    struct CanonicalKey {
+        uint64_t words[Words];
+
+        template <typename Cell>
+        static CanonicalKey fromCell(const Cell& cell) {
+            static_assert(sizeof(Cell) / sizeof(int) == 2 * Words, "the cell must have two indices per key word");
+            Cell sorted = cell;
+            std::sort(sorted.begin(), sorted.end());
+            CanonicalKey key;
+            for (int w = 0; w < Words; ++w) {
+                key.words[w] = (uint64_t)(uint32_t)sorted[2 * w] << 32 | (uint32_t)sorted[2 * w + 1];
+            }
+            return key;
+        }
+
+        bool operator==(const CanonicalKey& other) const {
+            for (int w = 0; w < Words; ++w) {
+                if (words[w] != other.words[w]) return false;
+            }
+            return true;
+        }
+
+        // Byte `digit` of the key, counting from the least significant byte.
+        unsigned byteAt(int digit) const { return (unsigned)(words[Words - 1 - digit / 8] >> (digit % 8 * 8)) & 0xff; }
+    };
+
+    template <int Words>
+    struct KeyedIndex {
+        CanonicalKey<Words> key;
+        uint32_t index;
+    };
+
+    /**
+     * @brief Stable parallel LSD radix sort of keyed items, one byte per pass.
+     *
+     * Each worker histograms its own contiguous slice, the per-worker offsets are laid out in
+     * (digit, worker) order and every worker scatters its slice, which keeps equal keys in
+     * input order. Passes in which all keys share the same byte (typically the high bytes of
+     * every index) are skipped.
+     */
+    template <int Words>
+    inline void radixSortKeys(std::vector<KeyedIndex<Words>>& items) {
+        const size_t count = items.size();
+        if (count < 2) return;
+        const int workers = std::max(1, std::min(threadCount(), (int)(count / 16384)));
+        const size_t slice = (count + workers - 1) / workers;
+        auto sliceBegin = [&](int w) { return std::min(count, (size_t)w * slice); };
+
+        std::vector<KeyedIndex<Words>> buffer(count);
+        std::vector<std::array<size_t, 256>> offsets(workers);
+        for (int digit = 0; digit < Words * 8; ++digit) {
+            parallelFor(0, workers, [&](int w) {
+                offsets[w].fill(0);
+                for (size_t i = sliceBegin(w); i < sliceBegin(w + 1); ++i) ++offsets[w][items[i].key.byteAt(digit)];
+            }, 1);
+
+            bool allSame = false;
+            size_t running = 0;
+            for (int b = 0; b < 256; ++b) {
+                size_t bucket = 0;
+                for (int w = 0; w < workers; ++w) bucket += offsets[w][b];
+                if (bucket == count) allSame = true;
+                for (int w = 0; w < workers; ++w) {
+                    size_t n = offsets[w][b];
+                    offsets[w][b] = running;
+                    running += n;
+                }
+            }
+            if (allSame) continue;
+
+            parallelFor(0, workers, [&](int w) {
+                std::array<size_t, 256>& next = offsets[w];
+                for (size_t i = sliceBegin(w); i < sliceBegin(w + 1); ++i) buffer[next[items[i].key.byteAt(digit)]++] = items[i];
+            }, 1);
+            items.swap(buffer);
+        }
+    }
+
+    /**
+     * @brief Removes cells with the same vertex set, keeping the first of each in input order.
+     *
+     * The result is ordered by canonical key, so it does not depend on how the candidates were
+     * produced or on the thread count.
+     */
+    template <int Words, typename Cell>
+    inline std::vector<Cell> dedupByCanonicalKey(const std::vector<Cell>& cells) {
+        std::vector<KeyedIndex<Words>> items(cells.size());
+        parallelFor(0, (int)cells.size(), [&](int i) {
+            items[i].key = CanonicalKey<Words>::fromCell(cells[i]);
+            items[i].index = (uint32_t)i;
+        }, 4096);
+        radixSortKeys(items);
+
+        std::vector<Cell> unique;
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (i == 0 || !(items[i].key == items[i - 1].key)) unique.push_back(cells[items[i].index]);
+        }
+        return unique;
+    }
+
+    inline std::vector<QuadFace> dedupFaces(const std::vector<QuadFace>& faces) { return dedupByCanonicalKey<2>(faces); }
+    inline std::vector<Hexahedron> dedupHexahedra(const std::vector<Hexahedron>& hexahedra) { return dedupByCanonicalKey<4>(hexahedra); }
+
+    /**
+     * @brief Step 2 without the shared hash set: candidates are gathered in parallel and
+     * deduplicated with dedupFaces.
+     *
+     * Yields the same faces, with the same orientation, as findValidFaces, ordered by their
+     * sorted vertex indices.
+     */
+    template <typename Graph>
+    inline std::vector<QuadFace> findValidFacesRadix(const std::vector<MeshPoint>& points, const Graph& adjGraph,
+                                                     const FaceTolerances& tolerances = FaceTolerances()) {
+        std::vector<std::vector<QuadFace>> perWorker(threadCount());
+        parallelForChunks(0, (int)points.size(), [&](int chunkBegin, int chunkEnd, int worker) {
+            for (int p0_idx = chunkBegin; p0_idx < chunkEnd; ++p0_idx) {
+                forEachFaceCandidate(p0_idx, points, adjGraph, tolerances, [&](const QuadFace& face) {
+                    perWorker[worker].push_back(face);
+                });
+            }
+        });
+
+        // Workers own consecutive point ranges, so concatenating keeps the serial candidate order.
+        std::vector<QuadFace> candidates;
+        for (const std::vector<QuadFace>& faces : perWorker) candidates.insert(candidates.end(), faces.begin(), faces.end());
+        return dedupFaces(candidates);
+    }
+
+    /**
+     * @brief Step 3 with radix-sort deduplication: face pairs are tested in parallel and the
+     * candidates deduplicated with dedupHexahedra.
+     *
+     * Yields the same hexahedra, with the same corner order, as buildHexahedra, ordered by
+     * their sorted vertex indices.
+     */
+    template <typename Graph>
+    inline std::vector<Hexahedron> buildHexahedraRadix(const std::vector<QuadFace>& validFaces, const Graph& adjGraph) {
+        // Row i is paired with the F-1-i faces after it; the rows are split into one block per
+        // worker with equal numbers of pairs.
+        const size_t faceCount = validFaces.size();
+        const int blocks = std::max(1, threadCount());
+        std::vector<size_t> blockBegin(blocks + 1, faceCount);
+        blockBegin[0] = 0;
+        const double totalPairs = 0.5 * faceCount * (faceCount > 0 ? faceCount - 1 : 0);
+        double pairs = 0.0;
+        int block = 1;
+        for (size_t i = 0; i < faceCount && block < blocks; ++i) {
+            pairs += (double)(faceCount - 1 - i);
+            if (pairs >= totalPairs * block / blocks) blockBegin[block++] = i + 1;
+        }
+
+        std::vector<std::vector<Hexahedron>> perWorker(blocks);
+        parallelFor(0, blocks, [&](int b) {
+            for (size_t i = blockBegin[b]; i < blockBegin[b + 1]; ++i) {
+                for (size_t j = i + 1; j < faceCount; ++j) {
+                    Hexahedron hex;
+                    if (pairOppositeFaces(validFaces[i], validFaces[j], adjGraph, hex)) perWorker[b].push_back(hex);
+                }
+            }
+        }, 1);
+
+        std::vector<Hexahedron> candidates;
+        for (const std::vector<Hexahedron>& hexes : perWorker) candidates.insert(candidates.end(), hexes.begin(), hexes.end());
+        return dedupHexahedra(candidates);
+    }
+} // namespace ReconstructionEngine
+
+#endif // RADIX_DEDUP_H
@@ -10,6 +10,9 @@
 #include <QVector3D>
 #include <QDebug>
 #include <QSet>
+#include "parallel.h"
+#include "cancellation.h"
+#include "progress.h"
 
 // --- Type Definitions ---
 using Vector3 = QVector3D;
@@ -32,6 +35,18 @@ using QuadFace = std::array<int, 4>;
 // Represents a hexahedral cell.
 using Hexahedron = std::array<int, 8>;
 
+/**
+ * @struct FaceTolerances
+ * @brief Acceptance thresholds of the Step 2 face tests.
+ */
+struct FaceTolerances {
+    float coplanarity;   // Upper bound on |(p1-p0) . ((p2-p0) x (p3-p0))|.
+    float diagonalRatio; // Both squared diagonals must exceed the longest squared edge times this.
+
+    FaceTolerances(float coplanarity = 1e-3f, float diagonalRatio = 1.01f)
+        : coplanarity(coplanarity), diagonalRatio(diagonalRatio) {}
+};
+
 
 // --- Helper Functions ---
 
@@ -52,132 +67,275 @@ inline bool arePointsCoplanar(const std::vector<MeshPoint>& points, const QuadFa
     return std::abs(volume) < tolerance;
 }
 
+/**
+ * @brief Checks that both diagonals of a quadrilateral are longer than any of its four edges.
+ */
+inline bool passesDiagonalTest(const std::vector<MeshPoint>& points, const QuadFace& face, float diagonalRatio = 1.01f) {
+    const Vector3& p0 = points[face[0]].pos;
+    const Vector3& p1 = points[face[1]].pos;
+    const Vector3& p2 = points[face[2]].pos;
+    const Vector3& p3 = points[face[3]].pos;
+    float edge01_sq = (p0 - p1).lengthSquared();
+    float edge12_sq = (p1 - p2).lengthSquared();
+    float edge23_sq = (p2 - p3).lengthSquared();
+    float edge30_sq = (p3 - p0).lengthSquared();
+
+    float diag02_sq = (p0 - p2).lengthSquared();
+    float diag13_sq = (p1 - p3).lengthSquared();
+
+    float max_edge_sq = std::max({edge01_sq, edge12_sq, edge23_sq, edge30_sq});
+    return diag02_sq > max_edge_sq * diagonalRatio && diag13_sq > max_edge_sq * diagonalRatio;
+}
+
+/**
+ * @brief Checks whether a 4-cycle is a structural face: coplanar, and passing the diagonal test.
+ */
+inline bool isStructuralFace(const std::vector<MeshPoint>& points, const QuadFace& face,
+                             const FaceTolerances& tolerances = FaceTolerances()) {
+    return arePointsCoplanar(points, face, tolerances.coplanarity) && passesDiagonalTest(points, face, tolerances.diagonalRatio);
+}
+
+// Corners of the six faces of a Hexahedron as produced by buildHexahedra (corners 0-3 and 4-7
+// are the two opposite faces, corner k+4 is linked to corner k), wound outwards.
+static const int kHexahedronFaces[6][4] = {
+    {0, 3, 2, 1}, {4, 5, 6, 7},
+    {0, 4, 7, 3}, {1, 2, 6, 5},
+    {0, 1, 5, 4}, {3, 7, 6, 2}
+};
+
+// Corners of the twelve edges of a Hexahedron.
+static const int kHexahedronEdges[12][2] = {
+    {0, 1}, {1, 2}, {2, 3}, {3, 0},
+    {4, 5}, {5, 6}, {6, 7}, {7, 4},
+    {0, 4}, {1, 5}, {2, 6}, {3, 7}
+};
+
 namespace ReconstructionEngine {
+    /**
+     * @brief Returns the `required_neighbors` points closest to point `i`, nearest first.
+     */
+    inline std::vector<int> nearestNeighbors(const std::vector<MeshPoint>& points, int i) {
+        std::vector<std::pair<float, int>> distances;
+        for (size_t j = 0; j < points.size(); ++j) {
+            if (i == (int)j) continue;
+            distances.push_back({points[i].pos.distanceToPoint(points[j].pos), (int)j});
+        }
+        std::sort(distances.begin(), distances.end());
+
+        std::vector<int> nearest;
+        int k_neighbors = points[i].required_neighbors;
+        for (int k = 0; k < k_neighbors && k < (int)distances.size(); ++k) {
+            nearest.push_back(distances[k].second);
+        }
+        return nearest;
+    }
+
     /**
      * @brief Step 1: Build the adjacency graph based on precise neighbor constraints.
+     *
+     * If `stop` triggers, returns the rows built so far (those of the first points) and sets
+     * `status` accordingly. `progress` counts points as stage "step1".
      */
-    inline AdjacencyGraph buildAdjacencyGraph(const std::vector<MeshPoint>& points) {
+    inline AdjacencyGraph buildAdjacencyGraph(const std::vector<MeshPoint>& points, const StopCondition& stop = StopCondition(),
+                                              StepStatus* status = nullptr, ProgressCounter* progress = nullptr) {
         AdjacencyGraph adjGraph;
-        if (points.empty()) return adjGraph;
+        StopCheck check(stop);
+        beginProgress(progress, "step1", points.size());
+        for (size_t i = 0; i < points.size() && !check.shouldStop(); ++i) {
+            std::vector<int> nearest = nearestNeighbors(points, (int)i);
+            adjGraph[(int)i] = std::unordered_set<int>(nearest.begin(), nearest.end());
+            reportProgress(progress, 0, 1);
+        }
+        reportStatus(status, check.status());
+        return adjGraph;
+    }
 
-        for (size_t i = 0; i < points.size(); ++i) {
-            std::vector<std::pair<float, int>> distances;
-            for (size_t j = 0; j < points.size(); ++j) {
-                if (i == j) continue;
-                distances.push_back({points[i].pos.distanceToPoint(points[j].pos), (int)j});
+    /**
+     * @brief Step 1 with the rows of the kNN graph computed in parallel. If `stop` triggers,
+     * every worker stops after its current row and the rows built so far are returned. Each
+     * worker counts its points in its own `progress` slot.
+     */
+    inline AdjacencyGraph buildAdjacencyGraphParallel(const std::vector<MeshPoint>& points, const StopCondition& stop = StopCondition(),
+                                                      StepStatus* status = nullptr, ProgressCounter* progress = nullptr) {
+        std::vector<std::vector<int>> rows(points.size());
+        std::vector<char> built(points.size(), 0);
+        std::atomic<int> stoppedAs((int)StepStatus::Completed);
+        beginProgress(progress, "step1", points.size());
+        parallelForChunks(0, (int)points.size(), [&](int chunkBegin, int chunkEnd, int worker) {
+            StopCheck check(stop);
+            for (int i = chunkBegin; i < chunkEnd; ++i) {
+                if (check.shouldStop()) {
+                    stoppedAs.store((int)check.status());
+                    return;
+                }
+                rows[i] = nearestNeighbors(points, i);
+                built[i] = 1;
+                reportProgress(progress, worker, 1);
             }
-            std::sort(distances.begin(), distances.end());
+        }, 16);
 
-            adjGraph[(int)i] = {};
-            int k_neighbors = points[i].required_neighbors;
-            for (int k = 0; k < k_neighbors && k < (int)distances.size(); ++k) {
-                adjGraph[(int)i].insert(distances[k].second);
-            }
+        AdjacencyGraph adjGraph;
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (built[i]) adjGraph[(int)i] = std::unordered_set<int>(rows[i].begin(), rows[i].end());
         }
+        reportStatus(status, (StepStatus)stoppedAs.load());
         return adjGraph;
     }
 
-    /**
-     * @brief Step 2: Identify all valid quadrilateral faces from the graph.
-     */
-    inline std::vector<QuadFace> findValidFaces(const std::vector<MeshPoint>& points, const AdjacencyGraph& adjGraph) {
-        std::vector<QuadFace> validFaces;
-        QSet<QVector<int>> uniqueFaces;
+    // --- Graph Access ---
+    // Steps 2 and 3 only reach the graph through these three functions, so they also run on
+    // other graph representations that provide overloads of them in this namespace.
 
-        for (int p0_idx = 0; p0_idx < (int)points.size(); ++p0_idx) {
-            if (!adjGraph.count(p0_idx)) continue;
+    inline bool hasVertex(const AdjacencyGraph& adjGraph, int v) { return adjGraph.count(v) != 0; }
 
-            std::vector<int> neighbors(adjGraph.at(p0_idx).begin(), adjGraph.at(p0_idx).end());
+    inline bool hasEdge(const AdjacencyGraph& adjGraph, int from, int to) {
+        auto row = adjGraph.find(from);
+        return row != adjGraph.end() && row->second.count(to) != 0;
+    }
 
-            for (size_t i = 0; i < neighbors.size(); ++i) {
-                for (size_t j = i + 1; j < neighbors.size(); ++j) {
-                    int p1_idx = neighbors[i];
-                    int p3_idx = neighbors[j];
+    template <typename Fn>
+    inline void forEachNeighbor(const AdjacencyGraph& adjGraph, int v, Fn fn) {
+        auto row = adjGraph.find(v);
+        if (row == adjGraph.end()) return;
+        for (int neighbor : row->second) fn(neighbor);
+    }
 
-                    if (!adjGraph.count(p1_idx) || !adjGraph.count(p3_idx)) continue;
-                    for (int p2_idx : adjGraph.at(p1_idx)) {
-                        if (p2_idx != p0_idx && adjGraph.at(p3_idx).count(p2_idx)) {
-                            QuadFace potentialFace = {p0_idx, p1_idx, p2_idx, p3_idx};
+    /**
+     * @brief Calls fn(face) for every 4-cycle through point `p0_idx` that passes the face tests.
+     *
+     * A face is reported once for each way it is reached, so the caller deduplicates.
+     */
+    template <typename Graph, typename Fn>
+    inline void forEachFaceCandidate(int p0_idx, const std::vector<MeshPoint>& points, const Graph& adjGraph,
+                                     const FaceTolerances& tolerances, Fn fn) {
+        if (!hasVertex(adjGraph, p0_idx)) return;
+
+        std::vector<int> neighbors;
+        forEachNeighbor(adjGraph, p0_idx, [&neighbors](int n) { neighbors.push_back(n); });
+
+        for (size_t i = 0; i < neighbors.size(); ++i) {
+            for (size_t j = i + 1; j < neighbors.size(); ++j) {
+                int p1_idx = neighbors[i];
+                int p3_idx = neighbors[j];
+
+                if (!hasVertex(adjGraph, p1_idx) || !hasVertex(adjGraph, p3_idx)) continue;
+                forEachNeighbor(adjGraph, p1_idx, [&](int p2_idx) {
+                    if (p2_idx != p0_idx && hasEdge(adjGraph, p3_idx, p2_idx)) {
+                        QuadFace potentialFace = {p0_idx, p1_idx, p2_idx, p3_idx};
+                        if (isStructuralFace(points, potentialFace, tolerances)) fn(potentialFace);
+                    }
+                });
+            }
+        }
+    }
 
-                            if (arePointsCoplanar(points, potentialFace)) {
-                                float edge01_sq = (points[p0_idx].pos - points[p1_idx].pos).lengthSquared();
-                                float edge12_sq = (points[p1_idx].pos - points[p2_idx].pos).lengthSquared();
-                                float edge23_sq = (points[p2_idx].pos - points[p3_idx].pos).lengthSquared();
-                                float edge30_sq = (points[p3_idx].pos - points[p0_idx].pos).lengthSquared();
+    /**
+     * @brief Collects the valid faces through point `p0_idx` that are not yet in `uniqueFaces`.
+     */
+    template <typename Graph>
+    inline void collectFacesFrom(int p0_idx, const std::vector<MeshPoint>& points, const Graph& adjGraph,
+                                 QSet<QVector<int>>& uniqueFaces, std::vector<QuadFace>& validFaces,
+                                 const FaceTolerances& tolerances = FaceTolerances()) {
+        forEachFaceCandidate(p0_idx, points, adjGraph, tolerances, [&](const QuadFace& potentialFace) {
+            QVector<int> sortedFace = {potentialFace[0], potentialFace[1], potentialFace[2], potentialFace[3]};
+            std::sort(sortedFace.begin(), sortedFace.end());
+
+            if (!uniqueFaces.contains(sortedFace)) {
+                validFaces.push_back(potentialFace);
+                uniqueFaces.insert(sortedFace);
+            }
+        });
+    }
 
-                                float diag02_sq = (points[p0_idx].pos - points[p2_idx].pos).lengthSquared();
-                                float diag13_sq = (points[p1_idx].pos - points[p3_idx].pos).lengthSquared();
+    /**
+     * @brief Step 2: Identify all valid quadrilateral faces from the graph.
+     *
+     * If `stop` triggers, returns the faces found from the points searched so far. `progress`
+     * counts points as stage "step2".
+     */
+    template <typename Graph>
+    inline std::vector<QuadFace> findValidFaces(const std::vector<MeshPoint>& points, const Graph& adjGraph,
+                                                const FaceTolerances& tolerances = FaceTolerances(),
+                                                const StopCondition& stop = StopCondition(), StepStatus* status = nullptr,
+                                                ProgressCounter* progress = nullptr) {
+        std::vector<QuadFace> validFaces;
+        QSet<QVector<int>> uniqueFaces;
 
-                                float max_edge_sq = std::max({edge01_sq, edge12_sq, edge23_sq, edge30_sq});
+        StopCheck check(stop);
+        beginProgress(progress, "step2", points.size());
+        for (int p0_idx = 0; p0_idx < (int)points.size() && !check.shouldStop(); ++p0_idx) {
+            collectFacesFrom(p0_idx, points, adjGraph, uniqueFaces, validFaces, tolerances);
+            reportProgress(progress, 0, 1);
+        }
+        reportStatus(status, check.status());
+        return validFaces;
+    }
 
-                                if (diag02_sq > max_edge_sq * 1.01f && diag13_sq > max_edge_sq * 1.01f) {
-                                    QVector<int> sortedFace = {p0_idx, p1_idx, p2_idx, p3_idx};
-                                    std::sort(sortedFace.begin(), sortedFace.end());
+    /**
+     * @brief Tests whether two faces are opposite faces of a hexahedron and, if so, builds it.
+     *
+     * Corners 0-3 of `hex` follow `face1`, corner k+4 is the vertex of `face2` linked to corner k.
+     */
+    template <typename Graph>
+    inline bool pairOppositeFaces(const QuadFace& face1, const QuadFace& face2, const Graph& adjGraph, Hexahedron& hex) {
+        // --- Check 1: Faces must be disjoint (no shared vertices).
+        QSet<int> face1_pts;
+        for(int p : face1) face1_pts.insert(p);
+        for(int p : face2) {
+            if (face1_pts.contains(p)) return false;
+        }
 
-                                    if (!uniqueFaces.contains(sortedFace)) {
-                                        validFaces.push_back(potentialFace);
-                                        uniqueFaces.insert(sortedFace);
-                                    }
-                                }
-                            }
-                        }
-                    }
+        // --- Check 2: There must be exactly 4 connecting edges between them.
+        std::vector<std::pair<int, int>> connecting_edges;
+        for (int p1 : face1) {
+            if (!hasVertex(adjGraph, p1)) continue;
+            for (int p2 : face2) {
+                if (hasEdge(adjGraph, p1, p2)) {
+                    connecting_edges.push_back({p1, p2});
                 }
             }
         }
-        return validFaces;
+        if (connecting_edges.size() != 4) return false;
+
+        // --- Check 3: Verify that each vertex is used exactly once in the connections.
+        QSet<int> f1_check, f2_check;
+        for(const auto& edge : connecting_edges) {
+            f1_check.insert(edge.first);
+            f2_check.insert(edge.second);
+        }
+        if (f1_check.size() != 4 || f2_check.size() != 4) return false;
+
+        for(int k=0; k<4; ++k) hex[k] = connecting_edges[k].first;
+        for(int k=0; k<4; ++k) hex[k+4] = connecting_edges[k].second;
+        return true;
     }
 
+    // Step 3 tests every unordered pair of faces.
+    inline uint64_t facePairCount(size_t faceCount) { return faceCount < 2 ? 0 : (uint64_t)faceCount * (faceCount - 1) / 2; }
+
     /**
      * @brief Step 3: Build hexahedral cells from the list of valid faces using a robust face-pairing strategy.
+     *
+     * If `stop` triggers, returns the cells found from the faces paired so far. `progress`
+     * counts face pairs as stage "step3", adding a whole row of pairs per outer iteration, so
+     * the fraction is exact although the rows shrink.
      */
-    inline std::vector<Hexahedron> buildHexahedra(const std::vector<QuadFace>& validFaces, const AdjacencyGraph& adjGraph) {
+    template <typename Graph>
+    inline std::vector<Hexahedron> buildHexahedra(const std::vector<QuadFace>& validFaces, const Graph& adjGraph,
+                                                  const StopCondition& stop = StopCondition(), StepStatus* status = nullptr,
+                                                  ProgressCounter* progress = nullptr) {
         std::vector<Hexahedron> candidateHexahedra;
 
         // Iterate through all possible pairs of faces to find opposite pairs.
-        for (size_t i = 0; i < validFaces.size(); ++i) {
+        StopCheck check(stop);
+        beginProgress(progress, "step3", facePairCount(validFaces.size()));
+        for (size_t i = 0; i < validFaces.size() && !check.shouldStop(); ++i) {
+            reportProgress(progress, 0, validFaces.size() - 1 - i);
             for (size_t j = i + 1; j < validFaces.size(); ++j) {
-                const auto& face1 = validFaces[i];
-                const auto& face2 = validFaces[j];
-
-                // --- Check 1: Faces must be disjoint (no shared vertices).
-                QSet<int> face1_pts;
-                for(int p : face1) face1_pts.insert(p);
-                bool disjoint = true;
-                for(int p : face2) {
-                    if (face1_pts.contains(p)) {
-                        disjoint = false;
-                        break;
-                    }
-                }
-                if (!disjoint) continue;
-
-                // --- Check 2: There must be exactly 4 connecting edges between them.
-                std::vector<std::pair<int, int>> connecting_edges;
-                for (int p1 : face1) {
-                    if (!adjGraph.count(p1)) continue;
-                    for (int p2 : face2) {
-                        if (adjGraph.at(p1).count(p2)) {
-                            connecting_edges.push_back({p1, p2});
-                        }
-                    }
-                }
-
-                if (connecting_edges.size() == 4) {
-                    // --- Check 3: Verify that each vertex is used exactly once in the connections.
-                    QSet<int> f1_check, f2_check;
-                    for(const auto& edge : connecting_edges) {
-                        f1_check.insert(edge.first);
-                        f2_check.insert(edge.second);
-                    }
-
-                    if (f1_check.size() == 4 && f2_check.size() == 4) {
-                        // We found a valid hexahedron candidate.
-                        Hexahedron hex;
-                        for(int k=0; k<4; ++k) hex[k] = connecting_edges[k].first;
-                        for(int k=0; k<4; ++k) hex[k+4] = connecting_edges[k].second;
-                        candidateHexahedra.push_back(hex);
-                    }
+                Hexahedron hex;
+                if (pairOppositeFaces(validFaces[i], validFaces[j], adjGraph, hex)) {
+                    // We found a valid hexahedron candidate.
+                    candidateHexahedra.push_back(hex);
                 }
             }
         }
@@ -200,8 +358,35 @@ namespace ReconstructionEngine {
             }
         }
 
+        reportStatus(status, check.status());
         return finalHexahedra;
     }
+
+    /**
+     * @struct ReconstructionResult
+     * @brief The outputs of all three steps for one point cloud.
+     */
+    struct ReconstructionResult {
+        AdjacencyGraph adjGraph;
+        std::vector<QuadFace> faces;
+        std::vector<Hexahedron> hexahedra;
+        StepStatus status = StepStatus::Completed;  // Of the step that stopped, if one did.
+    };
+
+    /**
+     * @brief Runs Steps 1-3 back to back. If `stop` triggers, the step it interrupts returns
+     * its partial results and the later steps are skipped. `progress` follows each step in turn.
+     */
+    inline ReconstructionResult reconstruct(const std::vector<MeshPoint>& points, const FaceTolerances& tolerances = FaceTolerances(),
+                                            const StopCondition& stop = StopCondition(), ProgressCounter* progress = nullptr) {
+        ReconstructionResult result;
+        result.adjGraph = buildAdjacencyGraph(points, stop, &result.status, progress);
+        if (result.status != StepStatus::Completed) return result;
+        result.faces = findValidFaces(points, result.adjGraph, tolerances, stop, &result.status, progress);
+        if (result.status != StepStatus::Completed) return result;
+        result.hexahedra = buildHexahedra(result.faces, result.adjGraph, stop, &result.status, progress);
+        return result;
+    }
 } // namespace ReconstructionEngine
 
 #endif // RECONSTRUCTION_ENGINE_H
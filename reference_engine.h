@@ -0,0 +1,176 @@
+#ifndef REFERENCE_ENGINE_H
+#define REFERENCE_ENGINE_H
+
+#include <algorithm>
+#include <cmath>
+#include "reconstruction_engine.h"
+
+/**
+ * @namespace ReferenceEngine
+ * @brief The original brute-force Steps 1-3, kept as the oracle that optimized paths are
+ * checked against (see differential_check.h).
+ *
+ * This is deliberately a frozen, self-contained copy: it shares only the data types with
+ * ReconstructionEngine and none of its helpers, so an optimization of those helpers cannot
+ * silently change the oracle as well. Only the face tolerances were made parameters. Do not
+ * optimize this file.
+ */
+namespace ReferenceEngine {
+    /**
+     * @brief Step 1: Build the adjacency graph based on precise neighbor constraints.
+     */
+    inline AdjacencyGraph buildAdjacencyGraph(const std::vector<MeshPoint>& points) {
+        AdjacencyGraph adjGraph;
+        if (points.empty()) return adjGraph;
+
+        for (size_t i = 0; i < points.size(); ++i) {
+            std::vector<std::pair<float, int>> distances;
+            for (size_t j = 0; j < points.size(); ++j) {
+                if (i == j) continue;
+                distances.push_back({points[i].pos.distanceToPoint(points[j].pos), (int)j});
+            }
+            std::sort(distances.begin(), distances.end());
+
+            adjGraph[(int)i] = {};
+            int k_neighbors = points[i].required_neighbors;
+            for (int k = 0; k < k_neighbors && k < (int)distances.size(); ++k) {
+                adjGraph[(int)i].insert(distances[k].second);
+            }
+        }
+        return adjGraph;
+    }
+
+    /**
+     * @brief Step 2: Identify all valid quadrilateral faces from the graph.
+     */
+    inline std::vector<QuadFace> findValidFaces(const std::vector<MeshPoint>& points, const AdjacencyGraph& adjGraph,
+                                                const FaceTolerances& tolerances = FaceTolerances()) {
+        std::vector<QuadFace> validFaces;
+        QSet<QVector<int>> uniqueFaces;
+
+        for (int p0_idx = 0; p0_idx < (int)points.size(); ++p0_idx) {
+            if (!adjGraph.count(p0_idx)) continue;
+
+            std::vector<int> neighbors(adjGraph.at(p0_idx).begin(), adjGraph.at(p0_idx).end());
+
+            for (size_t i = 0; i < neighbors.size(); ++i) {
+                for (size_t j = i + 1; j < neighbors.size(); ++j) {
+                    int p1_idx = neighbors[i];
+                    int p3_idx = neighbors[j];
+
+                    if (!adjGraph.count(p1_idx) || !adjGraph.count(p3_idx)) continue;
+                    for (int p2_idx : adjGraph.at(p1_idx)) {
+                        if (p2_idx != p0_idx && adjGraph.at(p3_idx).count(p2_idx)) {
+                            if (p1_idx >= (int)points.size() || p2_idx >= (int)points.size() || p3_idx >= (int)points.size()) continue;
+                            const Vector3& q0 = points[p0_idx].pos;
+                            const Vector3& q1 = points[p1_idx].pos;
+                            const Vector3& q2 = points[p2_idx].pos;
+                            const Vector3& q3 = points[p3_idx].pos;
+                            float volume = QVector3D::dotProduct(q1 - q0, QVector3D::crossProduct(q2 - q0, q3 - q0));
+
+                            if (std::abs(volume) < tolerances.coplanarity) {
+                                float edge01_sq = (q0 - q1).lengthSquared();
+                                float edge12_sq = (q1 - q2).lengthSquared();
+                                float edge23_sq = (q2 - q3).lengthSquared();
+                                float edge30_sq = (q3 - q0).lengthSquared();
+
+                                float diag02_sq = (q0 - q2).lengthSquared();
+                                float diag13_sq = (q1 - q3).lengthSquared();
+
+                                float max_edge_sq = std::max({edge01_sq, edge12_sq, edge23_sq, edge30_sq});
+
+                                if (diag02_sq > max_edge_sq * tolerances.diagonalRatio && diag13_sq > max_edge_sq * tolerances.diagonalRatio) {
+                                    QVector<int> sortedFace = {p0_idx, p1_idx, p2_idx, p3_idx};
+                                    std::sort(sortedFace.begin(), sortedFace.end());
+
+                                    if (!uniqueFaces.contains(sortedFace)) {
+                                        validFaces.push_back({p0_idx, p1_idx, p2_idx, p3_idx});
+                                        uniqueFaces.insert(sortedFace);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return validFaces;
+    }
+
+    /**
+     * @brief Step 3: Build hexahedral cells from the list of valid faces using a robust face-pairing strategy.
+     */
+    inline std::vector<Hexahedron> buildHexahedra(const std::vector<QuadFace>& validFaces, const AdjacencyGraph& adjGraph) {
+        std::vector<Hexahedron> candidateHexahedra;
+
+        // Iterate through all possible pairs of faces to find opposite pairs.
+        for (size_t i = 0; i < validFaces.size(); ++i) {
+            for (size_t j = i + 1; j < validFaces.size(); ++j) {
+                const auto& face1 = validFaces[i];
+                const auto& face2 = validFaces[j];
+
+                // --- Check 1: Faces must be disjoint (no shared vertices).
+                QSet<int> face1_pts;
+                for(int p : face1) face1_pts.insert(p);
+                bool disjoint = true;
+                for(int p : face2) {
+                    if (face1_pts.contains(p)) {
+                        disjoint = false;
+                        break;
+                    }
+                }
+                if (!disjoint) continue;
+
+                // --- Check 2: There must be exactly 4 connecting edges between them.
+                std::vector<std::pair<int, int>> connecting_edges;
+                for (int p1 : face1) {
+                    if (!adjGraph.count(p1)) continue;
+                    for (int p2 : face2) {
+                        if (adjGraph.at(p1).count(p2)) {
+                            connecting_edges.push_back({p1, p2});
+                        }
+                    }
+                }
+
+                if (connecting_edges.size() == 4) {
+                    // --- Check 3: Verify that each vertex is used exactly once in the connections.
+                    QSet<int> f1_check, f2_check;
+                    for(const auto& edge : connecting_edges) {
+                        f1_check.insert(edge.first);
+                        f2_check.insert(edge.second);
+                    }
+
+                    if (f1_check.size() == 4 && f2_check.size() == 4) {
+                        // We found a valid hexahedron candidate.
+                        Hexahedron hex;
+                        for(int k=0; k<4; ++k) hex[k] = connecting_edges[k].first;
+                        for(int k=0; k<4; ++k) hex[k+4] = connecting_edges[k].second;
+                        candidateHexahedra.push_back(hex);
+                    }
+                }
+            }
+        }
+
+        // Deduplicate the results.
+        std::vector<Hexahedron> finalHexahedra;
+        QSet<QVector<int>> uniqueHexes;
+        for (const auto& hex : candidateHexahedra) {
+            QVector<int> sortedHex(8);
+            for(int k=0; k<8; ++k) sortedHex[k] = hex[k];
+            std::sort(sortedHex.begin(), sortedHex.end());
+
+            QSet<int> pointSet;
+            for(int p_idx : sortedHex) pointSet.insert(p_idx);
+            if(pointSet.size() != 8) continue;
+
+            if (!uniqueHexes.contains(sortedHex)) {
+                finalHexahedra.push_back(hex);
+                uniqueHexes.insert(sortedHex);
+            }
+        }
+
+        return finalHexahedra;
+    }
+} // namespace ReferenceEngine
+
+#endif // REFERENCE_ENGINE_H
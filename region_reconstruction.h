@@ -0,0 +1,160 @@
+#ifndef REGION_RECONSTRUCTION_H
+#define REGION_RECONSTRUCTION_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "reconstruction_engine.h"
+#include "spatial_index.h"
+
+namespace ReconstructionEngine {
+    const float kDefaultHaloSpacings = 2.0f;  // Halo that gives the points near a region their true neighbors.
+
+    /**
+     * @struct RegionOfInterest
+     * @brief A half-open box [minCorner, maxCorner) or a closed sphere.
+     */
+    struct RegionOfInterest {
+        enum Shape { Box, Sphere };
+
+        Shape shape = Box;
+        Vector3 minCorner;  // Box
+        Vector3 maxCorner;
+        Vector3 center;     // Sphere
+        float radius = 0.0f;
+
+        static RegionOfInterest box(const Vector3& minCorner, const Vector3& maxCorner) {
+            RegionOfInterest roi;
+            roi.minCorner = minCorner;
+            roi.maxCorner = maxCorner;
+            return roi;
+        }
+
+        static RegionOfInterest sphere(const Vector3& center, float radius) {
+            RegionOfInterest roi;
+            roi.shape = Sphere;
+            roi.center = center;
+            roi.radius = radius;
+            return roi;
+        }
+
+        bool contains(const Vector3& p) const {
+            if (shape == Sphere) return (p - center).lengthSquared() <= radius * radius;
+            return p.x() >= minCorner.x() && p.y() >= minCorner.y() && p.z() >= minCorner.z() &&
+                   p.x() < maxCorner.x() && p.y() < maxCorner.y() && p.z() < maxCorner.z();
+        }
+
+        // The region widened by `margin` on every side.
+        RegionOfInterest grown(float margin) const {
+            if (shape == Sphere) return sphere(center, radius + margin);
+            Vector3 m(margin, margin, margin);
+            return box(minCorner - m, maxCorner + m);
+        }
+
+        // Axis-aligned bounds of the region.
+        void bounds(Vector3& lo, Vector3& hi) const {
+            if (shape == Sphere) {
+                Vector3 r(radius, radius, radius);
+                lo = center - r;
+                hi = center + r;
+            } else {
+                lo = minCorner;
+                hi = maxCorner;
+            }
+        }
+    };
+
+    /**
+     * @struct RegionResult
+     * @brief Output of reconstructRegion. Graph rows, faces and cells refer to the indices of
+     * the full point set.
+     */
+    struct RegionResult {
+        std::vector<int> pointIndices;     // The points that were reconstructed (region and halo), ascending.
+        int corePoints = 0;                // How many of them lie in the region itself.
+        AdjacencyGraph adjGraph;           // Rows of the points in the region only.
+        std::vector<QuadFace> faces;
+        std::vector<Hexahedron> hexahedra;
+        int64_t coreIncidences = 0;        // Cells around each point in the region, summed over those points.
+    };
+
+    // Mean position of the listed points.
+    template <size_t N>
+    inline Vector3 centroidOf(const std::vector<MeshPoint>& points, const std::array<int, N>& corners) {
+        Vector3 sum;
+        for (int v : corners) sum += points[v].pos;
+        return sum / (float)N;
+    }
+
+    /**
+     * @brief Runs Steps 1-3 on the points of `roi` plus a `halo` margin, fetched through
+     * `index`, and returns the faces and cells whose centroid lies in the region.
+     *
+     * The halo gives the points around the region their true nearest neighbors, so the faces
+     * and cells near the region come out as in a reconstruction of the full set, while those
+     * cut off at the outer edge of the halo are dropped; kDefaultHaloSpacings point spacings
+     * suffice for lattice-like inputs. Assigning by centroid puts every cell in exactly one of
+     * several disjoint regions. With the index built once, each call costs time in the number
+     * of points near the region only.
+     */
+    inline RegionResult reconstructRegion(const std::vector<MeshPoint>& points, const UniformGridIndex& index,
+                                          const RegionOfInterest& roi, float halo,
+                                          const FaceTolerances& tolerances = FaceTolerances()) {
+        RegionResult result;
+        RegionOfInterest context = roi.grown(halo);
+        Vector3 lo, hi;
+        context.bounds(lo, hi);
+        index.forEachInBox(lo, hi, [&](int i) {
+            if (context.contains(points[i].pos)) result.pointIndices.push_back(i);
+        });
+        // Keep the original order, so that Step 1 breaks distance ties as on the full set.
+        std::sort(result.pointIndices.begin(), result.pointIndices.end());
+
+        const std::vector<int>& global = result.pointIndices;
+        std::vector<MeshPoint> subset;
+        std::vector<char> inRegion;
+        subset.reserve(global.size());
+        inRegion.reserve(global.size());
+        for (int i : global) {
+            subset.push_back(points[i]);
+            inRegion.push_back(roi.contains(points[i].pos) ? 1 : 0);
+        }
+        result.corePoints = (int)std::count(inRegion.begin(), inRegion.end(), 1);
+
+        AdjacencyGraph graph = buildAdjacencyGraph(subset);
+        std::vector<QuadFace> faces = findValidFaces(subset, graph, tolerances);
+        std::vector<Hexahedron> hexahedra = buildHexahedra(faces, graph);
+
+        for (const auto& row : graph) {
+            if (!inRegion[row.first]) continue;
+            std::unordered_set<int>& mapped = result.adjGraph[global[row.first]];
+            for (int n : row.second) mapped.insert(global[n]);
+        }
+        for (const QuadFace& face : faces) {
+            if (!roi.contains(centroidOf(subset, face))) continue;
+            result.faces.push_back({global[face[0]], global[face[1]], global[face[2]], global[face[3]]});
+        }
+        for (const Hexahedron& hex : hexahedra) {
+            for (int v : hex) result.coreIncidences += inRegion[v];
+            if (!roi.contains(centroidOf(subset, hex))) continue;
+            Hexahedron mapped;
+            for (int k = 0; k < 8; ++k) mapped[k] = global[hex[k]];
+            result.hexahedra.push_back(mapped);
+        }
+        return result;
+    }
+
+    /**
+     * @brief reconstructRegion with a halo of kDefaultHaloSpacings point spacings. Builds the
+     * spatial index first, which takes O(N); keep an index and call the overload above to
+     * inspect several regions of the same cloud.
+     */
+    inline RegionResult reconstructRegion(const std::vector<MeshPoint>& points, const RegionOfInterest& roi,
+                                          const FaceTolerances& tolerances = FaceTolerances()) {
+        UniformGridIndex index(points);
+        return reconstructRegion(points, index, roi, kDefaultHaloSpacings * index.cellSize(), tolerances);
+    }
+} // namespace ReconstructionEngine
+
+#endif // REGION_RECONSTRUCTION_H
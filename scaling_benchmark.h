@@ -0,0 +1,153 @@
+#ifndef SCALING_BENCHMARK_H
+#define SCALING_BENCHMARK_H
+
+#include <chrono>
+#include <QString>
+#include <QStringList>
+#include "reconstruction_engine.h"
+#include "parallel.h"
+#include "concurrent_key_set.h"
+#include "point_generators.h"
+
+namespace ReconstructionEngine {
+    /**
+     * @struct ScalingOptions
+     * @brief Parameters of runScalingBenchmark.
+     */
+    struct ScalingOptions {
+        std::vector<int> threadCounts = {1, 2, 4, 8, 16, 32, 64};
+        int gridSize = 10;          // Lattice points per axis of the strong-scaling grid and of the 1-thread weak grid.
+        float jitter = 0.1f;        // In units of the lattice spacing, per lattice line (faces stay planar).
+        bool strong = true;         // Fixed problem size.
+        bool weak = true;           // Problem size proportional to the thread count.
+        int repetitions = 1;        // The fastest repetition is reported.
+        double threshold = 0.7;     // Stages below this parallel efficiency are flagged.
+    };
+
+    /**
+     * @struct ScalingSample
+     * @brief The time of one stage at one thread count.
+     */
+    struct ScalingSample {
+        QString mode;     // "strong" or "weak".
+        QString stage;    // "step1", "step2", "step3" or "total".
+        int threads = 0;
+        int points = 0;
+        double seconds = 0.0;
+        double speedup = 1.0;    // Against the first thread count; for weak scaling, scaled by the size ratio.
+        double efficiency = 1.0; // speedup / (threads / first thread count).
+        bool flagged = false;    // Efficiency below the threshold.
+    };
+
+    /**
+     * @brief Runs Steps 1-3 on generated grids across thread counts and reports per-stage
+     * speedup and parallel efficiency.
+     *
+     * Step 1 computes the kNN rows in parallel; Steps 2 and 3 run findValidFacesConcurrent and
+     * buildHexahedraConcurrent. Strong scaling keeps a gridSize^3 lattice; weak scaling
+     * stretches it along x so the point count grows with the thread count. Weak efficiency is
+     * t(first) / t(T) as usual; since Steps 1 and 3 are quadratic in the input, it also shows
+     * the algorithmic growth, not only parallel overhead. The global thread count is restored
+     * afterwards.
+     */
+    inline std::vector<ScalingSample> runScalingBenchmark(const ScalingOptions& options) {
+        typedef std::chrono::steady_clock Clock;
+        auto seconds = [](Clock::time_point since) { return std::chrono::duration<double>(Clock::now() - since).count(); };
+
+        std::vector<ScalingSample> samples;
+        if (options.threadCounts.empty()) return samples;
+        const int previousThreads = threadCountSetting().load();
+        const int baseThreads = std::max(options.threadCounts.front(), 1);
+
+        QStringList modes;
+        if (options.strong) modes << "strong";
+        if (options.weak) modes << "weak";
+        for (const QString& mode : modes) {
+            std::vector<ScalingSample> baseline;
+            for (int threads : options.threadCounts) {
+                threads = std::max(threads, 1);
+                setThreadCount(threads);
+                int nx = mode == "weak" ? options.gridSize * threads / baseThreads : options.gridSize;
+                std::vector<MeshPoint> points = generateGridPoints(nx, options.gridSize, options.gridSize, 1.0f, options.jitter);
+
+                double best[4] = {0.0, 0.0, 0.0, 0.0};
+                for (int r = 0; r < std::max(options.repetitions, 1); ++r) {
+                    double times[4];
+                    Clock::time_point start = Clock::now();
+                    AdjacencyGraph adjGraph = buildAdjacencyGraphParallel(points);
+                    times[0] = seconds(start);
+                    start = Clock::now();
+                    std::vector<QuadFace> faces = findValidFacesConcurrent(points, adjGraph);
+                    times[1] = seconds(start);
+                    start = Clock::now();
+                    buildHexahedraConcurrent(faces, adjGraph);
+                    times[2] = seconds(start);
+                    times[3] = times[0] + times[1] + times[2];
+                    for (int s = 0; s < 4; ++s) best[s] = r == 0 ? times[s] : std::min(best[s], times[s]);
+                }
+
+                static const char* const kStages[4] = {"step1", "step2", "step3", "total"};
+                for (int s = 0; s < 4; ++s) {
+                    ScalingSample sample;
+                    sample.mode = mode;
+                    sample.stage = kStages[s];
+                    sample.threads = threads;
+                    sample.points = (int)points.size();
+                    sample.seconds = best[s];
+                    if (baseline.size() < 4) {
+                        baseline.push_back(sample);
+                    } else {
+                        const ScalingSample& base = baseline[s];
+                        double ratio = (double)threads / base.threads;
+                        double timeRatio = base.seconds / std::max(sample.seconds, 1e-12);
+                        sample.speedup = mode == "weak" ? timeRatio * sample.points / std::max(base.points, 1) : timeRatio;
+                        sample.efficiency = sample.speedup / ratio;
+                        sample.flagged = sample.efficiency < options.threshold;
+                    }
+                    samples.push_back(sample);
+                }
+            }
+        }
+        setThreadCount(previousThreads);
+        return samples;
+    }
+
+    /**
+     * @brief Formats samples as CSV with a header row.
+     */
+    inline QString formatScalingCsv(const std::vector<ScalingSample>& samples) {
+        QString csv = "mode,stage,threads,points,seconds,speedup,efficiency,flagged\n";
+        for (const ScalingSample& s : samples) {
+            csv += QString("%1,%2,%3,%4,%5,%6,%7,%8\n").arg(s.mode).arg(s.stage).arg(s.threads).arg(s.points)
+                       .arg(s.seconds, 0, 'g', 6).arg(s.speedup, 0, 'f', 3).arg(s.efficiency, 0, 'f', 3).arg(s.flagged ? 1 : 0);
+        }
+        return csv;
+    }
+
+    /**
+     * @brief Formats samples as one efficiency table per mode (threads down, stages across),
+     * marking flagged entries with '!'.
+     */
+    inline QString formatScalingTable(const std::vector<ScalingSample>& samples) {
+        QString table;
+        QString mode;
+        for (size_t i = 0; i < samples.size(); i += 4) {
+            if (samples[i].mode != mode) {
+                mode = samples[i].mode;
+                table += QString("\n%1 scaling (parallel efficiency, seconds)\n").arg(mode);
+                table += QString("%1 %2 %3 %4 %5 %6\n").arg("threads", 7).arg("points", 9)
+                             .arg("step1", 18).arg("step2", 18).arg("step3", 18).arg("total", 18);
+            }
+            table += QString("%1 %2").arg(samples[i].threads, 7).arg(samples[i].points, 9);
+            for (size_t s = i; s < i + 4 && s < samples.size(); ++s) {
+                QString cell = QString("%1%2 (%3)").arg(samples[s].efficiency, 0, 'f', 2).arg(samples[s].flagged ? "!" : "")
+                                   .arg(samples[s].seconds, 0, 'g', 3);
+                table += QString(" %1").arg(cell, 18);
+            }
+            table += '\n';
+        }
+        return table;
+    }
+} // namespace ReconstructionEngine
+
+#endif // SCALING_BENCHMARK_H
@@ -0,0 +1,195 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "reconstruction_engine.h"
+
+/**
+ * @class UniformGridIndex
+ * @brief Bucket grid over a point set for nearest-neighbor and range queries.
+ *
+ * Points are stored cell by cell in a compressed (CSR) layout. Unless a cell size is given,
+ * it is chosen so that a cell holds about one point on average; flat inputs such as a
+ * single layer are handled by ignoring the degenerate axes.
+ */
+class UniformGridIndex {
+public:
+    UniformGridIndex() : m_cellSize(1.0f) { m_dims[0] = m_dims[1] = m_dims[2] = 0; }
+
+    explicit UniformGridIndex(const std::vector<MeshPoint>& points, float cellSize = 0.0f) : UniformGridIndex() {
+        m_positions.reserve(points.size());
+        for (const MeshPoint& p : points) m_positions.push_back(p.pos);
+        build(cellSize);
+    }
+
+    bool isEmpty() const { return m_positions.empty(); }
+    float cellSize() const { return m_cellSize; }
+
+    /**
+     * @brief Returns the index of the point closest to `query`, or -1 if the index is empty.
+     */
+    int nearest(const Vector3& query, int exclude = -1) const {
+        if (m_positions.empty()) return -1;
+        int center[3];
+        int maxRing = 0;
+        for (int a = 0; a < 3; ++a) {
+            center[a] = (int)std::floor((query[a] - m_min[a]) / m_cellSize);
+            maxRing = std::max(maxRing, std::max(std::abs(center[a]), std::abs(center[a] - (m_dims[a] - 1))));
+        }
+
+        int best = -1;
+        float bestDistSq = std::numeric_limits<float>::max();
+        for (int ring = 0; ring <= maxRing; ++ring) {
+            for (int z = center[2] - ring; z <= center[2] + ring; ++z) {
+                if (z < 0 || z >= m_dims[2]) continue;
+                for (int y = center[1] - ring; y <= center[1] + ring; ++y) {
+                    if (y < 0 || y >= m_dims[1]) continue;
+                    for (int x = center[0] - ring; x <= center[0] + ring; ++x) {
+                        if (x < 0 || x >= m_dims[0]) continue;
+                        // Only visit the shell of the current ring; inner cells were already searched.
+                        if (std::abs(x - center[0]) != ring && std::abs(y - center[1]) != ring && std::abs(z - center[2]) != ring) continue;
+                        int cell = cellIndex(x, y, z);
+                        for (int k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k) {
+                            int idx = m_indices[k];
+                            if (idx == exclude) continue;
+                            float distSq = (m_positions[idx] - query).lengthSquared();
+                            if (distSq < bestDistSq || (distSq == bestDistSq && idx < best)) {
+                                bestDistSq = distSq;
+                                best = idx;
+                            }
+                        }
+                    }
+                }
+            }
+            // Every cell beyond this ring is at least ring * cellSize away from the query.
+            float reach = ring * m_cellSize;
+            if (best >= 0 && bestDistSq <= reach * reach) break;
+        }
+        return best;
+    }
+
+    /**
+     * @brief Calls fn(index) for every point inside the closed box [lo, hi].
+     *
+     * Only the cells overlapping the box are visited, so the cost grows with the size of the
+     * box rather than with the whole point set. Points come in cell order.
+     */
+    template <typename Fn>
+    void forEachInBox(const Vector3& lo, const Vector3& hi, Fn fn) const {
+        if (m_positions.empty()) return;
+        int first[3], last[3];
+        for (int a = 0; a < 3; ++a) {
+            if (hi[a] < lo[a]) return;
+            first[a] = cellCoord(lo[a], a);
+            last[a] = cellCoord(hi[a], a);
+        }
+        for (int z = first[2]; z <= last[2]; ++z) {
+            for (int y = first[1]; y <= last[1]; ++y) {
+                for (int x = first[0]; x <= last[0]; ++x) {
+                    int cell = cellIndex(x, y, z);
+                    for (int k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k) {
+                        int idx = m_indices[k];
+                        const Vector3& p = m_positions[idx];
+                        if (p.x() >= lo.x() && p.y() >= lo.y() && p.z() >= lo.z() &&
+                            p.x() <= hi.x() && p.y() <= hi.y() && p.z() <= hi.z()) fn(idx);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    int cellIndex(int x, int y, int z) const { return (z * m_dims[1] + y) * m_dims[0] + x; }
+
+    int cellCoord(float value, int axis) const {
+        int c = (int)std::floor((value - m_min[axis]) / m_cellSize);
+        return std::min(std::max(c, 0), m_dims[axis] - 1);
+    }
+
+    void build(float cellSize) {
+        if (m_positions.empty()) return;
+        Vector3 maxCorner = m_positions[0];
+        m_min = m_positions[0];
+        for (const Vector3& p : m_positions) {
+            for (int a = 0; a < 3; ++a) {
+                m_min[a] = std::min(m_min[a], p[a]);
+                maxCorner[a] = std::max(maxCorner[a], p[a]);
+            }
+        }
+
+        if (cellSize <= 0.0f) {
+            // Aim for one point per cell over the non-degenerate extent of the cloud.
+            double volume = 1.0;
+            int axes = 0;
+            for (int a = 0; a < 3; ++a) {
+                double extent = maxCorner[a] - m_min[a];
+                if (extent > 1e-6) { volume *= extent; ++axes; }
+            }
+            cellSize = axes ? (float)std::pow(volume / m_positions.size(), 1.0 / axes) : 1.0f;
+        }
+        m_cellSize = std::max(cellSize, 1e-6f);
+
+        for (int a = 0; a < 3; ++a) {
+            m_dims[a] = (int)std::floor((maxCorner[a] - m_min[a]) / m_cellSize) + 1;
+        }
+
+        // Counting sort of the points into their cells.
+        std::vector<int> cellOf(m_positions.size());
+        m_cellStart.assign((size_t)m_dims[0] * m_dims[1] * m_dims[2] + 1, 0);
+        for (size_t i = 0; i < m_positions.size(); ++i) {
+            const Vector3& p = m_positions[i];
+            cellOf[i] = cellIndex(cellCoord(p.x(), 0), cellCoord(p.y(), 1), cellCoord(p.z(), 2));
+            ++m_cellStart[cellOf[i] + 1];
+        }
+        for (size_t c = 1; c < m_cellStart.size(); ++c) m_cellStart[c] += m_cellStart[c - 1];
+        std::vector<int> fill(m_cellStart.begin(), m_cellStart.end() - 1);
+        m_indices.resize(m_positions.size());
+        for (size_t i = 0; i < m_positions.size(); ++i) m_indices[fill[cellOf[i]]++] = (int)i;
+    }
+
+    std::vector<Vector3> m_positions;
+    Vector3 m_min;
+    float m_cellSize;
+    int m_dims[3];
+    std::vector<int> m_cellStart;
+    std::vector<int> m_indices;
+};
+
+namespace ReconstructionEngine {
+    /**
+     * @brief The kNN row of point `i` exactly as nearestNeighbors(points, i) builds it, found
+     * in the cells around the point instead of by sorting the whole cloud. `index` must have
+     * been built over `points`.
+     *
+     * A box around the point doubles in size until the k-th nearest point inside it lies
+     * clearly within the box; every point outside is farther away, so no closer one was missed.
+     */
+    inline std::vector<int> nearestNeighbors(const std::vector<MeshPoint>& points, const UniformGridIndex& index, int i) {
+        std::vector<int> nearest;
+        int k = std::min(points[i].required_neighbors, (int)points.size() - 1);
+        if (k <= 0) return nearest;
+
+        const Vector3& center = points[i].pos;
+        std::vector<std::pair<float, int>> distances;
+        for (float half = index.cellSize();; half *= 2.0f) {
+            if (std::isinf(half)) return nearestNeighbors(points, i); // Non-finite coordinates.
+            distances.clear();
+            Vector3 extent(half, half, half);
+            index.forEachInBox(center - extent, center + extent, [&](int j) {
+                if (j != i) distances.push_back({center.distanceToPoint(points[j].pos), j});
+            });
+            bool wholeCloud = distances.size() + 1 == points.size();
+            if ((int)distances.size() < k && !wholeCloud) continue;
+            // Same (distance, index) order as the full sort, so ties resolve identically.
+            std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+            if (wholeCloud || distances[k - 1].first < half * 0.999f) break;
+        }
+        for (int n = 0; n < k; ++n) nearest.push_back(distances[n].second);
+        return nearest;
+    }
+} // namespace ReconstructionEngine
+
+#endif // SPATIAL_INDEX_H